@@ -1,15 +1,14 @@
 #pragma once
-#include <windows.h>
+#include "../Core/Platform.h"
 #include "../Core/Control.h"
 #include "../Core/Render.h"
 // ------------------ Button ------------------
 class Button : public Control, public Render {
 public:
     std::wstring text;
+    TextLayout caption;     // Подпись по центру; наведение меняет только атрибут
     Button(SMALL_RECT r, const std::wstring t) : Control(r), text(t) {
-        EventManager::getInstance().addHandler<MOUSE_EVENT_RECORD>([this](const MOUSE_EVENT_RECORD& mer) {
-            this->onMouse(mer);
-        });
+        MouseRouter::add(this);
     }
     void draw() override {
                           Render::attr = FOREGROUND_RED   | FOREGROUND_GREEN | FOREGROUND_BLUE;
@@ -17,7 +16,8 @@ public:
         if      (focused) Render::attr = BACKGROUND_GREEN | FOREGROUND_RED   | FOREGROUND_BLUE   | FOREGROUND_INTENSITY;
         Render::fillBox(rect);
         Render::DrawBox(rect);
-        Render::drawTextCentered(text, rect);
+        caption.update(text, rect, TextLayout::Align::Center);
+        Render::drawLayout(caption);
     }
 
     virtual void onMouse(const MOUSE_EVENT_RECORD& mer) = 0;
@@ -7,8 +7,7 @@ public:
     CFTextBox(SMALL_RECT r, std::wstring t) : TextBox(r, t) {}
     void onKey(const KEY_EVENT_RECORD& ker) override {
         if (ker.bKeyDown) {
-            if ((ker.uChar.UnicodeChar >= 32 && ker.uChar.UnicodeChar <= 126) ||        
-                    (ker.uChar.UnicodeChar >= 1040 && ker.uChar.UnicodeChar <= 1103)) {
+            if (CharWidth::isPrintable(ker.uChar.UnicodeChar)) {
                 text.push_back(ker.uChar.UnicodeChar);
             }
             else if (ker.wVirtualKeyCode == VK_BACK && !text.empty()) {
@@ -16,7 +15,7 @@ public:
             } else if (ker.wVirtualKeyCode == VK_RETURN) {
                 onEnter();
             }
-            draw();
+            invalidate();
         }
     }
     void onEnter();
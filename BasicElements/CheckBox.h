@@ -1,6 +1,6 @@
 
 #pragma once
-#include <windows.h>
+#include "../Core/Platform.h"
 #include "../Core/Control.h"
 #include "../Core/Render.h"
 // ------------------ CheckBox ------------------
@@ -8,16 +8,18 @@ class CheckBox : public Control, public Render {
 public:
     bool checked = false;
     std::wstring text;
+    TextLayout caption {TextLayout::Overflow::Clip};
     CheckBox(SMALL_RECT r, std::wstring t) : Control(r), text(t) {
-        EventManager::getInstance().addHandler<MOUSE_EVENT_RECORD>([this](const MOUSE_EVENT_RECORD& mer) {
-            this->onMouse(mer);
-        });
+        MouseRouter::add(this);
     }
 
     void drawContent() {
-        std::wstring displayText = checked ? L"[X] " : L"[ ] ";
-        displayText += text;
-        WriteConsoleOutputCharacterW(hout, displayText.c_str(), displayText.size(), { (SHORT)(rect.Left + 1), (SHORT)((rect.Top + rect.Bottom) / 2) }, &dump);
+        SHORT y = (SHORT)((rect.Top + rect.Bottom) / 2);
+        Cell mark[3] { { L'[', attr }, { checked ? L'X' : L' ', attr }, { L']', attr } };
+        Render::drawCells({ (SHORT)(rect.Left + 1), y }, mark, 3);
+        // Текст после "[X] ": TextLayout отступает на столбец от Left
+        caption.update(text, { (SHORT)(rect.Left + 4), rect.Top, rect.Right, rect.Bottom }, TextLayout::Align::Left);
+        Render::drawLayout(caption);
     }
 
     void draw() override {
@@ -43,6 +45,6 @@ public:
 
     void action() override {
         checked = !checked;
-        drawContent();
+        invalidate();
     }
 };  
\ No newline at end of file
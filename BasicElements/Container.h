@@ -3,6 +3,8 @@
 #include <memory>
 #include "../Core/Control.h"
 #include "../Core/Render.h"
+#include "../Core/MouseRouter.h"
+#include "../Core/FrameScheduler.h"
 #include <algorithm>
 
 // ------------------ Container ------------------
@@ -20,51 +22,81 @@ public:
     Alignment alignment { Start };
 
     Container(SMALL_RECT r, unsigned short d = Vertical) : Control(r), direction(d) {}
-    Container(SMALL_RECT r, LayoutDirection d, std::vector<std::shared_ptr<Control>> c, Alignment a = Start) : Control(r), direction(d), controls(c), alignment(a) {}
+    Container(SMALL_RECT r, LayoutDirection d, std::vector<std::shared_ptr<Control>> c, Alignment a = Start) : Control(r), direction(d), controls(c), alignment(a) {
+        for (size_t i = 0; i < controls.size(); ++i) {
+            controls[i]->parent = this;
+            controls[i]->childIndex = static_cast<int>(i);
+        }
+    }
+
+    ~Container() override {
+        for (auto& ctrl : controls) {
+            if (ctrl->parent == this) ctrl->parent = nullptr;
+        }
+    }
 
     void addControl(const std::shared_ptr<Control>& ctrl) {
         controls.push_back(ctrl);
+        ctrl->parent = this;
+        ctrl->childIndex = static_cast<int>(controls.size() - 1);
+        ctrl->desired = { 0, 0 };   // В contentLength ещё не учтён
+        ctrl->requestLayout();
     }
 
-    void removeControl(const std::shared_ptr<Control>& ctrl) {
-        controls.erase(std::remove(controls.begin(), controls.end(), ctrl), controls.end());
+    virtual void removeControl(const std::shared_ptr<Control>& ctrl) {
+        auto it = std::find(controls.begin(), controls.end(), ctrl);
+        if (it == controls.end()) return;
+        std::shared_ptr<Control> child = ctrl;  // ctrl может быть ссылкой на элемент controls
+        size_t index = static_cast<size_t>(it - controls.begin());
+        controls.erase(it);
+        for (size_t i = index; i < controls.size(); ++i) controls[i]->childIndex = static_cast<int>(i);
+        resized.erase(std::remove(resized.begin(), resized.end(), child.get()), resized.end());
+        nested.erase(std::remove(nested.begin(), nested.end(), child.get()), nested.end());
+        contentLength -= mainLength(child->desired);
+        dirtyFrom = (std::min)(dirtyFrom, index);
+        if (child->parent == this) child->parent = nullptr;
+        child->childIndex = -1;
+        invalidate(child->rect);    // На месте элемента - снова фон контейнера
+        markLayoutDirty();
     }
 
+    // Полная раскладка: все дети перемеряются и ставятся заново
     virtual void rearrangeControls() {
-        if (controls.empty()) return;
-
-        short totalLength = 0;
-        for (auto& ctrl : controls) {
-            totalLength += (direction == Vertical)
-                ? (ctrl->rect.Bottom - ctrl->rect.Top)
-                : (ctrl->rect.Right - ctrl->rect.Left);
-        }
-        totalLength += spacing * static_cast<short>(controls.size() - 1);
+        fullPass = remeasureAll = true;
+        relayout(false);
+    }
 
-        short availableLength = (direction == Vertical)
-            ? (rect.Bottom - rect.Top - padding.Top - padding.Bottom)
-            : (rect.Right - rect.Left - padding.Left - padding.Right);
+    // Только грязное: перемеряются дети, сменившие размер, сдвигаются те, что за первым из них,
+    // раскладываются грязные поддеревья. Сдвинутая полоса перерисовывается (invalidate)
+    void layout() override {
+        if (!layoutDirty) return;
+        relayout(true);
+    }
 
-        short offset = paddingOffset(availableLength, totalLength);
+    // Контейнер переставил родитель: дети ставятся заново, если rect изменился
+    void arrange(const SMALL_RECT& r) override {
+        bool moved = r.Left != rect.Left || r.Top != rect.Top || r.Right != rect.Right || r.Bottom != rect.Bottom;
+        Control::arrange(r);
+        fullPass = fullPass || moved;
+        if (fullPass || layoutDirty) relayout(false);   // Полосу перерисует родитель
+    }
 
-        for (auto& ctrl : controls) {
-            short w = ctrl->rect.Right - ctrl->rect.Left;
-            short h = ctrl->rect.Bottom - ctrl->rect.Top;
-
-            if (direction == Vertical) {
-                ctrl->rect.Top = rect.Top + padding.Top + offset;
-                ctrl->rect.Bottom = ctrl->rect.Top + h;
-                ctrl->rect.Left = rect.Left + padding.Left;
-                ctrl->rect.Right = rect.Right - padding.Right;
-                offset += h + spacing;
-            } else {
-                ctrl->rect.Left = rect.Left + padding.Left + offset;
-                ctrl->rect.Right = ctrl->rect.Left + w;
-                ctrl->rect.Top = rect.Top + padding.Top;
-                ctrl->rect.Bottom = rect.Bottom - padding.Bottom;
-                offset += w + spacing;
-            }
+    void childLayoutChanged(Control& child) override {
+        size_t index = static_cast<size_t>(child.childIndex);
+        if (child.childIndex < 0 || index >= controls.size() || controls[index].get() != &child) {
+            fullPass = remeasureAll = true;     // controls меняли в обход addControl
+            return;
         }
+        if (child.measureDirty) {
+            dirtyFrom = (std::min)(dirtyFrom, index);
+            resized.push_back(&child);
+        }
+        if (child.layoutDirty) nested.push_back(&child);
+    }
+
+    // Длина содержимого вдоль direction: дети и промежутки между ними
+    int contentExtent() const {
+        return controls.empty() ? 0 : contentLength + spacing * static_cast<int>(controls.size() - 1);
     }
 
     short paddingOffset(short available, short content) const {
@@ -77,8 +109,171 @@ public:
     }
 
     void draw() override {
+        paint(rect);
+    }
+
+    void paint(const SMALL_RECT& clip) override {
+        FrameScheduler::stats.visits++;
         Render::fillBox(rect);
         if (bordered) Render::DrawBox(rect);
-        for (auto& ctrl : controls) ctrl->draw();
+        for (auto& ctrl : controls) {
+            if (!ctrl->hidden) paintChild(*ctrl, clip);
+        }
+    }
+
+protected:
+    static constexpr size_t clean = static_cast<size_t>(-1);
+
+    int contentLength {0};                  // Сумма desired детей вдоль direction
+    bool fullPass {true};                   // Следующая раскладка ставит заново всех детей
+    bool remeasureAll {true};               // ... и перемеряет всех (rearrangeControls)
+    size_t dirtyFrom {clean};               // Первый ребёнок, с которого позиции могли сдвинуться
+    std::vector<Control*> resized;          // Перемеряны в этой раскладке (или ждут measure())
+    std::vector<Control*> nested;           // Ждут layout() своего поддерева
+
+    // Второй проход раскладки: поставить детей начиная с from (при fullPass from = 0);
+    // lastResized - индекс последнего перемеренного ребёнка. Возвращает область, которую надо
+    // перерисовать (Right < Left - ничего не сдвинулось). Стопка - дети друг за другом вдоль direction.
+    virtual SMALL_RECT arrangeChildren(size_t from, size_t lastResized) {
+        const size_t n = controls.size();
+        const int total = contentExtent();
+        const SMALL_RECT inset = insets();
+        const int base = direction == Vertical ? rect.Top + inset.Top : rect.Left + inset.Left;
+        // При выравнивании не к началу смена общей длины сдвигает всех
+        if (alignment != Start && total != previousExtent) from = 0;
+        int pos = from > 0 ? mainEnd(controls[from - 1]->rect) + spacing
+                           : base + paddingOffset(static_cast<short>(mainAvailable()), static_cast<short>(total)) - scrollOffset();
+        int bandStart = (std::min)(pos, mainStart(controls[from]->rect));
+        int bandEnd = bandStart;
+        bool reachedEnd = true;
+        for (size_t i = from; i < n; ++i) {
+            Control& ctrl = *controls[i];
+            SMALL_RECT r = placed(ctrl, pos);
+            pos += mainLength(ctrl.desired) + spacing;
+            bool same = sameRect(r, ctrl.rect);
+            if (same && i > lastResized) {
+                reachedEnd = false;     // Дальше никто не сдвинулся
+                break;
+            }
+            bandEnd = (std::max)({ bandEnd, mainEnd(r), mainEnd(ctrl.rect) });
+            if (!same || fullPass) ctrl.arrange(r);
+        }
+        // Полоса от первого сдвинутого ребёнка; если сдвинулись все до конца - до края контейнера
+        if (reachedEnd) bandEnd = mainEnd(rect);
+        if (direction == Vertical) return { rect.Left, static_cast<SHORT>(bandStart), rect.Right, static_cast<SHORT>(bandEnd) };
+        return { static_cast<SHORT>(bandStart), rect.Top, static_cast<SHORT>(bandEnd), rect.Bottom };
+    }
+
+    // Раскладка закончена (ScrollContainer пересчитывает по ней прокрутку)
+    virtual void arranged() {}
+    // На сколько содержимое сдвинуто назад вдоль direction (прокрутка)
+    virtual int scrollOffset() const { return 0; }
+
+    // Ребёнок рисуется, только если задевает clip, и не выходит за свой rect
+    static void paintChild(Control& ctrl, const SMALL_RECT& clip) {
+        if (!Render::intersects(ctrl.rect, clip)) return;
+        Render::Clip inner(ctrl.rect);
+        ctrl.paint(Render::intersect(clip, ctrl.rect));
+    }
+
+    static bool sameRect(const SMALL_RECT& a, const SMALL_RECT& b) {
+        return a.Left == b.Left && a.Top == b.Top && a.Right == b.Right && a.Bottom == b.Bottom;
+    }
+
+    // Ребёнок встаёт в r, если его место изменилось (или раскладка полная); r добавляется к damage
+    void place(Control& ctrl, const SMALL_RECT& r, SMALL_RECT& damage) {
+        bool same = sameRect(r, ctrl.rect);
+        if (same && !fullPass) return;
+        if (!same) damage = damage.Right < damage.Left ? FrameScheduler::unite(ctrl.rect, r) : FrameScheduler::unite(damage, FrameScheduler::unite(ctrl.rect, r));
+        ctrl.arrange(r);
+    }
+
+    // Отступы от rect до места детей (ScrollContainer добавляет к ним рамку)
+    virtual SMALL_RECT insets() const { return padding; }
+
+    // Ребёнок с началом в pos вдоль direction; поперёк - во всю ширину контейнера без отступов
+    SMALL_RECT placed(const Control& ctrl, int pos) const {
+        const SMALL_RECT inset = insets();
+        if (direction == Vertical) {
+            return { static_cast<SHORT>(rect.Left + inset.Left), static_cast<SHORT>(pos),
+                     static_cast<SHORT>(rect.Right - inset.Right), static_cast<SHORT>(pos + ctrl.desired.Y) };
+        }
+        return { static_cast<SHORT>(pos), static_cast<SHORT>(rect.Top + inset.Top),
+                 static_cast<SHORT>(pos + ctrl.desired.X), static_cast<SHORT>(rect.Bottom - inset.Bottom) };
+    }
+
+    int mainLength(COORD size) const { return direction == Vertical ? size.Y : size.X; }
+    int mainStart(const SMALL_RECT& r) const { return direction == Vertical ? r.Top : r.Left; }
+    int mainEnd(const SMALL_RECT& r) const { return direction == Vertical ? r.Bottom : r.Right; }
+    int mainAvailable() const {
+        const SMALL_RECT inset = insets();
+        return direction == Vertical ? rect.Bottom - rect.Top - inset.Top - inset.Bottom
+                                     : rect.Right - rect.Left - inset.Left - inset.Right;
+    }
+    int crossAvailable() const {
+        const SMALL_RECT inset = insets();
+        return direction == Vertical ? rect.Right - rect.Left - inset.Left - inset.Right
+                                     : rect.Bottom - rect.Top - inset.Top - inset.Bottom;
+    }
+
+    // Оба прохода раскладки; damage - перерисовать сдвинутую полосу
+    void relayout(bool damage) {
+        layoutDirty = false;
+        const size_t n = controls.size();
+        size_t lastResized = 0;
+        // Проход 1 (measure): все дети или только сменившие размер
+        if (fullPass) {
+            contentLength = 0;
+            resized.clear();
+            for (size_t i = 0; i < n; ++i) {
+                Control& ctrl = *controls[i];
+                ctrl.parent = this;
+                ctrl.childIndex = static_cast<int>(i);
+                if (remeasureAll || ctrl.measureDirty) {
+                    measureChild(ctrl);
+                    resized.push_back(&ctrl);
+                }
+                contentLength += mainLength(ctrl.desired);
+            }
+            dirtyFrom = 0;
+            lastResized = n;
+        } else {
+            for (Control* ctrl : resized) {
+                if (!ctrl->measureDirty) continue;
+                int old = mainLength(ctrl->desired);
+                measureChild(*ctrl);
+                contentLength += mainLength(ctrl->desired) - old;
+                lastResized = (std::max)(lastResized, static_cast<size_t>(ctrl->childIndex));
+            }
+        }
+
+        // Проход 2 (arrange). При выравнивании не к началу смена общей длины (в том числе удалением
+        // последнего ребёнка) сдвигает всех
+        SMALL_RECT band { 0, 0, -1, -1 };
+        if (n > 0 && alignment != Start && contentExtent() != previousExtent) {
+            if (dirtyFrom != clean) lastResized = (std::max)(lastResized, dirtyFrom);   // До места удаления не останавливаться
+            dirtyFrom = 0;
+        }
+        if (dirtyFrom < n) band = arrangeChildren(dirtyFrom, lastResized);
+        previousExtent = contentExtent();
+        resized.clear();
+        dirtyFrom = clean;
+        fullPass = remeasureAll = false;
+
+        for (Control* ctrl : nested) {
+            if (ctrl->parent == this) ctrl->layout();
+        }
+        nested.clear();
+
+        if (damage && band.Left <= band.Right && band.Top <= band.Bottom) invalidate(band);
+        arranged();
+    }
+
+private:
+    int previousExtent {0};                 // contentExtent() на прошлой раскладке (до add/removeControl)
+
+    static void measureChild(Control& ctrl) {
+        ctrl.desired = ctrl.measure();
+        ctrl.measureDirty = false;
     }
 };
@@ -17,7 +17,7 @@ public:
             } else if (ker.wVirtualKeyCode == VK_RETURN) {
                 onEnter(text);
             }
-            draw();
+            invalidate();
         }
     }
 };
\ No newline at end of file
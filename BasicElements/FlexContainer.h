@@ -0,0 +1,126 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Container.h"
+
+// Как ребёнок делит свободное место строки: grow - доля прибавки, shrink - доля нехватки
+// (нехватка делится ещё и пропорционально исходной длине, как во flexbox)
+struct FlexItem {
+    short grow {0};
+    short shrink {1};
+};
+
+// ------------------ FlexContainer ------------------
+// Дети друг за другом вдоль direction, исходная длина каждого - desired.
+// Не влезают - сжимаются по shrink; место осталось - прибавляется по grow, а если никто не растёт,
+// строка ставится по alignment. wrap - не влезший ребёнок переносится на следующую строку
+// (строки через lineSpacing, высота строки - по самому большому ребёнку в ней); без wrap одна строка
+// во всю ширину контейнера. Решение - один проход по детям, O(детей); переставляются только те,
+// чьё место изменилось, и перерисовываются только их старые и новые места.
+class FlexContainer : public Container {
+public:
+    bool wrap {false};
+    short lineSpacing {1};
+
+    FlexContainer(SMALL_RECT r, LayoutDirection d = Horizontal) : Container(r, d) {}
+
+    using Container::addControl;
+
+    void addControl(const std::shared_ptr<Control>& ctrl, FlexItem item) {
+        if (items.size() <= controls.size()) items.resize(controls.size() + 1);
+        items[controls.size()] = item;
+        Container::addControl(ctrl);
+    }
+
+    void setItem(Control& ctrl, FlexItem item) {
+        if (ctrl.parent != this || ctrl.childIndex < 0) return;
+        size_t index = static_cast<size_t>(ctrl.childIndex);
+        if (items.size() <= index) items.resize(index + 1);
+        items[index] = item;
+        fullPass = true;
+        markLayoutDirty();
+    }
+
+    FlexItem itemOf(size_t index) const {
+        return index < items.size() ? items[index] : FlexItem{};
+    }
+
+    void removeControl(const std::shared_ptr<Control>& ctrl) override {
+        if (ctrl->parent == this && ctrl->childIndex >= 0 && static_cast<size_t>(ctrl->childIndex) < items.size()) {
+            items.erase(items.begin() + ctrl->childIndex);
+        }
+        Container::removeControl(ctrl);
+    }
+
+    // Размеры детей не перемеряются: растянутый rect не должен становиться исходной длиной
+    void rearrangeControls() override {
+        fullPass = true;
+        relayout(false);
+    }
+
+protected:
+    SMALL_RECT arrangeChildren(size_t, size_t) override {
+        SMALL_RECT damage { 0, 0, -1, -1 };
+        const size_t n = controls.size();
+        const int available = mainAvailable();
+        const int mainBase = direction == Vertical ? rect.Top + padding.Top : rect.Left + padding.Left;
+        int crossPos = direction == Vertical ? rect.Left + padding.Left : rect.Top + padding.Top;
+        size_t first = 0;
+        while (first < n) {
+            // Строка: дети, пока влезают (хотя бы один)
+            size_t end = first;
+            int used = 0, grow = 0, lineCross = 0;
+            long long shrinkWeight = 0;
+            for (; end < n; ++end) {
+                int basis = mainLength(controls[end]->desired);
+                int next = used + (end > first ? spacing : 0) + basis;
+                if (wrap && end > first && next > available) break;
+                FlexItem item = itemOf(end);
+                used = next;
+                grow += item.grow;
+                shrinkWeight += static_cast<long long>(item.shrink) * basis;
+                lineCross = (std::max)(lineCross, crossLength(controls[end]->desired));
+            }
+            if (!wrap) lineCross = crossAvailable();
+
+            const int free = available - used;
+            int pos = mainBase + (grow == 0 && free > 0 ? paddingOffset(static_cast<short>(available), static_cast<short>(used)) : 0);
+            int seenGrow = 0;
+            long long seenShrink = 0;
+            for (size_t i = first; i < end; ++i) {
+                Control& ctrl = *controls[i];
+                FlexItem item = itemOf(i);
+                int size = mainLength(ctrl.desired);
+                if (free > 0 && grow > 0) {
+                    size += free * (seenGrow + item.grow) / grow - free * seenGrow / grow;
+                    seenGrow += item.grow;
+                } else if (free < 0 && shrinkWeight > 0) {
+                    const long long deficit = -free;
+                    long long weight = static_cast<long long>(item.shrink) * size;
+                    size -= static_cast<int>(deficit * (seenShrink + weight) / shrinkWeight - deficit * seenShrink / shrinkWeight);
+                    seenShrink += weight;
+                    size = (std::max)(size, 0);
+                }
+                place(ctrl, lineRect(pos, size, crossPos, lineCross), damage);
+                pos += size + spacing;
+            }
+            crossPos += lineCross + lineSpacing;
+            first = end;
+        }
+        return damage;
+    }
+
+private:
+    std::vector<FlexItem> items;    // По номеру ребёнка; недостающие - FlexItem{}
+
+    int crossLength(COORD size) const { return direction == Vertical ? size.X : size.Y; }
+
+    SMALL_RECT lineRect(int pos, int size, int crossPos, int crossSize) const {
+        if (direction == Vertical) {
+            return { static_cast<SHORT>(crossPos), static_cast<SHORT>(pos),
+                     static_cast<SHORT>(crossPos + crossSize), static_cast<SHORT>(pos + size) };
+        }
+        return { static_cast<SHORT>(pos), static_cast<SHORT>(crossPos),
+                 static_cast<SHORT>(pos + size), static_cast<SHORT>(crossPos + crossSize) };
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Container.h"
+
+// Дорожка сетки - строка или столбец
+struct GridTrack {
+    enum Sizing : uint8_t { Fixed, Auto, Star };
+
+    Sizing sizing {Star};
+    short value {1};        // Fixed - длина, Star - вес, для Auto не нужен
+
+    static GridTrack fixed(short length) { return { Fixed, length }; }
+    static GridTrack autoSize() { return { Auto, 0 }; }
+    static GridTrack star(short weight = 1) { return { Star, weight }; }
+};
+
+// Клетка ребёнка; row < 0 - следующая по порядку (по номеру ребёнка, строка за строкой)
+struct GridCell {
+    short row {-1};
+    short column {-1};
+    short rowSpan {1};
+    short columnSpan {1};
+};
+
+// ------------------ GridContainer ------------------
+// Сетка из дорожек rows и columns:
+//   Fixed - длина задана;
+//   Auto  - по самому большому ребёнку дорожки (desired; дети на несколько дорожек не учитываются);
+//   Star  - что осталось после Fixed и Auto, делится между Star по весу, остаток - первым.
+// Длина дорожки - как у rect (Right - Left), между дорожками spacing, как между детьми Container.
+// Строки сверх rows - Auto. Решение - один проход по детям и один по дорожкам, O(детей + дорожек).
+// Ребёнок сменил размер вне Auto-дорожек - сетка прежняя, на место встаёт только он.
+class GridContainer : public Container {
+public:
+    std::vector<GridTrack> rows;
+    std::vector<GridTrack> columns;
+
+    GridContainer(SMALL_RECT r, std::vector<GridTrack> rowTracks, std::vector<GridTrack> columnTracks)
+        : Container(r), rows(std::move(rowTracks)), columns(std::move(columnTracks)) {}
+
+    using Container::addControl;
+
+    void addControl(const std::shared_ptr<Control>& ctrl, GridCell cell) {
+        if (cells.size() <= controls.size()) cells.resize(controls.size() + 1);
+        cells[controls.size()] = cell;      // До раскладки, которую запустит addControl
+        Container::addControl(ctrl);
+    }
+
+    void setCell(Control& ctrl, GridCell cell) {
+        if (ctrl.parent != this || ctrl.childIndex < 0) return;
+        size_t index = static_cast<size_t>(ctrl.childIndex);
+        if (cells.size() <= index) cells.resize(index + 1);
+        cells[index] = cell;
+        fullPass = true;
+        markLayoutDirty();
+    }
+
+    void removeControl(const std::shared_ptr<Control>& ctrl) override {
+        if (ctrl->parent == this && ctrl->childIndex >= 0 && static_cast<size_t>(ctrl->childIndex) < cells.size()) {
+            cells.erase(cells.begin() + ctrl->childIndex);
+        }
+        fullPass = true;    // Клетки по порядку после него сдвинулись
+        Container::removeControl(ctrl);
+    }
+
+    // Размеры детей не перемеряются: растянутый клеткой rect не должен раздувать Auto-дорожки
+    void rearrangeControls() override {
+        fullPass = true;
+        relayout(false);
+    }
+
+    GridCell cellOf(size_t index) const {
+        GridCell cell = index < cells.size() ? cells[index] : GridCell{};
+        const size_t columnCount = columns.empty() ? 1 : columns.size();
+        if (cell.row < 0 || cell.column < 0) {
+            cell.row = static_cast<short>(index / columnCount);
+            cell.column = static_cast<short>(index % columnCount);
+        }
+        cell.column = static_cast<short>((std::min)(static_cast<size_t>(cell.column), columnCount - 1));
+        cell.rowSpan = (std::max)(cell.rowSpan, short(1));
+        cell.columnSpan = static_cast<short>((std::clamp)(static_cast<size_t>(cell.columnSpan), size_t(1), columnCount - cell.column));
+        return cell;
+    }
+
+protected:
+    SMALL_RECT arrangeChildren(size_t, size_t) override {
+        SMALL_RECT damage { 0, 0, -1, -1 };
+        if (!fullPass && !rowSizes.empty() && !resizedInAuto()) {
+            for (Control* ctrl : resized) place(*ctrl, cellRect(cellOf(static_cast<size_t>(ctrl->childIndex))), damage);
+            return damage;
+        }
+        solve();
+        for (size_t i = 0; i < controls.size(); ++i) place(*controls[i], cellRect(cellOf(i)), damage);
+        return damage;
+    }
+
+private:
+    std::vector<GridCell> cells;                // По номеру ребёнка; недостающие - по порядку
+    std::vector<int> rowSizes, columnSizes;     // Решение последней раскладки
+    std::vector<int> rowStarts, columnStarts;
+
+    static GridTrack trackAt(const std::vector<GridTrack>& tracks, size_t i) {
+        return i < tracks.size() ? tracks[i] : GridTrack::autoSize();
+    }
+
+    bool resizedInAuto() const {
+        for (Control* ctrl : resized) {
+            GridCell cell = cellOf(static_cast<size_t>(ctrl->childIndex));
+            if (static_cast<size_t>(cell.row) >= rowSizes.size()) return true;  // Новая строка
+            if (cell.rowSpan == 1 && trackAt(rows, cell.row).sizing == GridTrack::Auto) return true;
+            if (cell.columnSpan == 1 && trackAt(columns, cell.column).sizing == GridTrack::Auto) return true;
+        }
+        return false;
+    }
+
+    void solve() {
+        size_t rowCount = rows.size();
+        const size_t columnCount = columns.empty() ? 1 : columns.size();
+        for (size_t i = 0; i < controls.size(); ++i) {
+            GridCell cell = cellOf(i);
+            rowCount = (std::max)(rowCount, static_cast<size_t>(cell.row + cell.rowSpan));
+        }
+        rowSizes.assign(rowCount, 0);
+        columnSizes.assign(columnCount, 0);
+        // Auto - по самому большому ребёнку в одну дорожку
+        for (size_t i = 0; i < controls.size(); ++i) {
+            GridCell cell = cellOf(i);
+            const COORD& size = controls[i]->desired;
+            if (cell.rowSpan == 1) rowSizes[cell.row] = (std::max)(rowSizes[cell.row], static_cast<int>(size.Y));
+            if (cell.columnSpan == 1) columnSizes[cell.column] = (std::max)(columnSizes[cell.column], static_cast<int>(size.X));
+        }
+        distribute(rows, rowSizes, rect.Bottom - rect.Top - padding.Top - padding.Bottom);
+        distribute(columns, columnSizes, rect.Right - rect.Left - padding.Left - padding.Right);
+        starts(rowSizes, rowStarts, rect.Top + padding.Top);
+        starts(columnSizes, columnStarts, rect.Left + padding.Left);
+    }
+
+    // sizes на входе - Auto-длины по детям, на выходе - длины всех дорожек
+    void distribute(const std::vector<GridTrack>& tracks, std::vector<int>& sizes, int available) const {
+        int used = spacing * (static_cast<int>(sizes.size()) - 1);
+        int weights = 0;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            GridTrack track = trackAt(tracks, i);
+            if (track.sizing == GridTrack::Fixed) sizes[i] = track.value;
+            if (track.sizing == GridTrack::Star) {
+                sizes[i] = 0;
+                weights += track.value;
+            }
+            used += sizes[i];
+        }
+        if (weights <= 0) return;
+        const int free = (std::max)(0, available - used);
+        // Доля до дорожки включительно, округлённая вверх: лишние клетки достаются первым (10 на 3 - 4, 3, 3)
+        auto share = [&](int weight) { return (free * weight + weights - 1) / weights; };
+        int seen = 0;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            GridTrack track = trackAt(tracks, i);
+            if (track.sizing != GridTrack::Star) continue;
+            sizes[i] = share(seen + track.value) - share(seen);
+            seen += track.value;
+        }
+    }
+
+    void starts(const std::vector<int>& sizes, std::vector<int>& result, int base) const {
+        result.resize(sizes.size());
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            result[i] = base;
+            base += sizes[i] + spacing;
+        }
+    }
+
+    SMALL_RECT cellRect(const GridCell& cell) const {
+        size_t lastRow = (std::min)(static_cast<size_t>(cell.row + cell.rowSpan), rowSizes.size()) - 1;
+        size_t lastColumn = static_cast<size_t>(cell.column + cell.columnSpan) - 1;
+        return { static_cast<SHORT>(columnStarts[cell.column]), static_cast<SHORT>(rowStarts[cell.row]),
+                 static_cast<SHORT>(columnStarts[lastColumn] + columnSizes[lastColumn]),
+                 static_cast<SHORT>(rowStarts[lastRow] + rowSizes[lastRow]) };
+    }
+};
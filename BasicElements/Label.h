@@ -1,5 +1,5 @@
 #pragma once
-#include <windows.h>
+#include "../Core/Platform.h"
 #include "../Core/Control.h"
 #include "../Core/Render.h"
 // ------------------ Label ------------------
@@ -7,6 +7,7 @@ class Label : public Control, public Render {
 public:
     std::wstring text;
     uint8_t type {1};
+    TextLayout layout {TextLayout::Overflow::Clip};  // Обрезка по столбцам, пересобирается при смене текста/rect
     Label(SMALL_RECT r, const std::wstring t) : Control(r), text(t) {}
     Label(SMALL_RECT r, const std::wstring t, uint8_t tp) : Control(r), text(t), type(tp) {}
     void updateText() {
@@ -19,15 +20,14 @@ public:
         bool hasBorder = type & 1;
         short innerWidth = width - (hasBorder ? 2 : 0);
         if (innerWidth <= 0) return;
-        std::wstring visible = text.substr(0, innerWidth);
         if (hasBorder) Render::DrawBox(rect);
         SMALL_RECT textRect = rect;
         if (hasBorder) {
             textRect.Left++;
             textRect.Right--;
         }
-        if (type & 2) Render::drawTextCentered(visible, textRect);
-        else Render::drawTextLeft(visible, textRect);
+        layout.update(text, textRect, (type & 2) ? TextLayout::Align::Center : TextLayout::Align::Left);
+        Render::drawLayout(layout);
     }
 
     void onMouse(const MOUSE_EVENT_RECORD& mer) override {
@@ -36,7 +36,7 @@ public:
             hovered = isHovered(mer.dwMousePosition);
             if (hovered == wasHovered) return;
             type |= hovered << 1;
-            draw();
+            invalidate();
         }
     }
 };
@@ -1,76 +1,193 @@
 #pragma once
+#include <cstdlib>
 #include "Container.h"
 #define DEMO
 
+// Прокрутка - одно смещение scrollY: дети стоят в rect со сдвигом на него (Container::scrollOffset).
+// Щелчок колеса не обходит всех детей: сдвигаются только живые - задевающие окно прокрутки
+// [liveFrom, liveTo), - въехавшие соседи встают вплотную к ним, ушедшие из окна прячутся (hidden).
+// Rect остальных детей устаревают (stale) и исправляются при следующей раскладке.
+// Уже нарисованное сдвигается блоком в заднем буфере (Render::scrollArea), рисуются только
+// открывшиеся строки; частично видимые дети рисуются обрезанными по окну.
 class ScrollContainer : public Container {
 public:
-    short scrollY = 0;
-    short maxScroll = 0;
+    int scrollY = 0;
+    int maxScroll = 0;
 
     ScrollContainer(SMALL_RECT r, LayoutDirection d = Vertical) : Container(r, d) {
-        EventManager::getInstance().addHandler<MOUSE_EVENT_RECORD>([this](const MOUSE_EVENT_RECORD& mer) {
-            this->onMouse(mer);
-        });
-    }
-
-    void rearrangeControls() override {
-        Container::rearrangeControls();
-        if (controls.empty()) return;
-        short contentBottom{0};
-        for (const auto& ctrl : controls) {
-            if (ctrl->rect.Bottom > contentBottom) contentBottom = ctrl->rect.Bottom;
-        }        
-        maxScroll = static_cast<short>((std::max)(0, (contentBottom - (rect.Top + padding.Top)) - (rect.Bottom - rect.Top - padding.Top - padding.Bottom)));
+        MouseRouter::add(this);
     }
 
     void onMouse(const MOUSE_EVENT_RECORD& mer) override {
         if (!isHovered(mer.dwMousePosition)) return;
         if (mer.dwEventFlags == MOUSE_WHEELED) {
-            short scrollStep = (static_cast<short>(HIWORD(mer.dwButtonState)) > 0) ? 1 : -1;
-            // std::cout << "scrollStep: " << scrollStep << "!controls.empty(): " << controls.empty() << std::endl;
-            // std::cout << "controls[0]->rect.Top >= rect.Top + padding.Top: "  << (controls[0]->rect.Top >= rect.Top + padding.Top) << std::endl;
-            // std::cout << "controls.back()->rect.Bottom <= rect.Bottom - padding.Bottom: " << (controls.back()->rect.Bottom <= rect.Bottom - padding.Bottom) << std::endl;
-            if (scrollStep > 0 && !controls.empty() && controls[0]->rect.Top >= rect.Top + padding.Top) return;
-            if (scrollStep < 0 && !controls.empty() && controls.back()->rect.Bottom <= rect.Bottom - padding.Bottom) return;
-            for (auto& ctrl : controls) {
-                ctrl->rect.Top += scrollStep;
-                ctrl->rect.Bottom += scrollStep;
-            }
-            this->draw(); 
+            // Слитые события колеса приходят одной суммой: строка на каждые WHEEL_DELTA
+            short delta = static_cast<short>(HIWORD(mer.dwButtonState));
+            int steps = (std::max)(1, std::abs(delta) / WHEEL_DELTA);
+            scrollBy(delta > 0 ? -steps : steps);
             return;
         }
     }
 
-    void draw() override {
+    // Прокрутить на lines строк (вниз - больше нуля), в пределах 0..maxScroll
+    virtual void scrollBy(int lines) {
+        int target = (std::clamp)(scrollY + lines, 0, maxScroll);
+        if (target == scrollY) return;
+        int dy = scrollY - target;
+        scrollY = target;
+        shiftChildren(dy);
+        scrolled(dy);
+    }
+
+    // Окно прокрутки: rect без отступов и рамки (insets), в нём же стоят дети
+    SMALL_RECT viewport() const {
+        const SMALL_RECT inset = insets();
+        return { static_cast<SHORT>(rect.Left + inset.Left), static_cast<SHORT>(rect.Top + inset.Top),
+                 static_cast<SHORT>(rect.Right - inset.Right), static_cast<SHORT>(rect.Bottom - inset.Bottom) };
+    }
+
+    // Дети видны и получают мышь только в окне прокрутки
+    SMALL_RECT clientArea() const override { return viewport(); }
+
+    void paint(const SMALL_RECT& clip) override {
+        FrameScheduler::stats.visits++;
         Render::fillBox(rect, true);
         if (bordered) Render::DrawBox(rect);
-        const short viewTop = rect.Top + padding.Top;
-        const short viewBottom = rect.Bottom - padding.Bottom;
-        for (auto& ctrl : controls) {
-            if (ctrl->rect.Top >= viewTop && ctrl->rect.Bottom <= viewBottom) {
-                ctrl->hidden = false; 
-                ctrl->draw();
-            } else {
-                ctrl->hidden = true;  
-            }
+        const SMALL_RECT view = viewport();
+        if (!Render::intersects(clip, view)) return;
+        Render::Clip inner(view);
+        const SMALL_RECT area = Render::intersect(clip, view);
+        for (size_t i = liveFrom; i < liveTo && i < controls.size(); ++i) {
+            if (!controls[i]->hidden) paintChild(*controls[i], area);
         }
     }
 
+protected:
+    size_t liveFrom {0}, liveTo {0};    // Дети, задевающие окно; их rect всегда верны
+    bool stale {false};                 // У детей вне [liveFrom, liveTo) rect устарели
+
+    int scrollOffset() const override { return scrollY; }
+
+    // Дети не заходят на рамку: окно обрезает всё, что на ней
+    SMALL_RECT insets() const override {
+        const SHORT border = bordered ? 1 : 0;
+        return { (std::max)(padding.Left, border), (std::max)(padding.Top, border),
+                 (std::max)(padding.Right, border), (std::max)(padding.Bottom, border) };
+    }
+
+    SMALL_RECT arrangeChildren(size_t from, size_t lastResized) override {
+        if (direction == Vertical) {
+            for (Control* ctrl : resized) ctrl->hidden = true;    // Покажет arranged(), если попадёт в окно
+        }
+        if (stale) {
+            // Соседи живых могли устареть - раскладка от первого ребёнка до последнего
+            stale = false;
+            from = 0;
+            lastResized = controls.size();
+        }
+        return Container::arrangeChildren(from, lastResized);
+    }
+
+    // Длина содержимого известна контейнеру без обхода детей
+    void arranged() override {
+        const int viewport = mainAvailable();
+        const int start = paddingOffset(static_cast<short>(viewport), static_cast<short>(contentExtent()));
+        maxScroll = direction == Vertical ? (std::max)(0, start + contentExtent() - viewport) : 0;
+        if (scrollY > maxScroll) {
+            // Содержимое стало короче окна с прокруткой - все дети встают заново
+            scrollY = maxScroll;
+            Container::arrangeChildren(0, controls.size());
+            stale = false;
+            invalidate();
+        }
+        if (!stale) findLive();
+    }
+
+    // Содержимое уехало на dy строк: нарисованное сдвигается блоком, рисуются только открывшиеся строки.
+    // Окно видно не целиком, сдвиг больше окна или без заднего буфера и поддержки бэкенда - окно целиком
+    void scrolled(int dy) {
+        const SMALL_RECT view = viewport();
+        SMALL_RECT visible = view;
+        if (!visibleRoot(visible)) return;
+        const bool whole = visible.Left != view.Left || visible.Top != view.Top || visible.Right != view.Right || visible.Bottom != view.Bottom;
+        if (whole || std::abs(dy) > view.Bottom - view.Top || !Render::scrollArea(view, static_cast<SHORT>(dy))) {
+            invalidate(view);
+            return;
+        }
+        FrameScheduler::shiftDamage(view, static_cast<SHORT>(dy));
+        SMALL_RECT exposed = view;
+        if (dy > 0) exposed.Bottom = static_cast<SHORT>(view.Top + dy - 1);
+        else exposed.Top = static_cast<SHORT>(view.Bottom + dy + 1);
+        invalidate(exposed);
+    }
+
 private:
+    // Живые дети сдвигаются, въехавшие в окно встают вплотную к крайним живым (как в arrangeChildren),
+    // ушедшие из окна прячутся. Стоит O(детей в окне), от числа всех детей не зависит
+    void shiftChildren(int dy) {
+        const size_t n = controls.size();
+        if (liveFrom >= liveTo || liveTo > n) {
+            Container::arrangeChildren(0, n);
+            stale = false;
+            findLive();
+            return;
+        }
+        const SMALL_RECT view = viewport();
+        for (size_t i = liveFrom; i < liveTo; ++i) {
+            SMALL_RECT r = controls[i]->rect;
+            r.Top = static_cast<SHORT>(r.Top + dy);
+            r.Bottom = static_cast<SHORT>(r.Bottom + dy);
+            controls[i]->arrange(r);
+        }
+        while (liveTo < n && controls[liveTo - 1]->rect.Bottom + spacing <= view.Bottom) {
+            Control& next = *controls[liveTo++];
+            next.arrange(placed(next, controls[liveTo - 2]->rect.Bottom + spacing));
+            next.hidden = false;
+        }
+        while (liveFrom > 0 && controls[liveFrom]->rect.Top - spacing >= view.Top) {
+            Control& prev = *controls[--liveFrom];
+            prev.arrange(placed(prev, controls[liveFrom + 1]->rect.Top - spacing - prev.desired.Y));
+            prev.hidden = false;
+        }
+        while (liveTo - liveFrom > 1 && controls[liveFrom]->rect.Bottom < view.Top) controls[liveFrom++]->hidden = true;
+        while (liveTo - liveFrom > 1 && controls[liveTo - 1]->rect.Top > view.Bottom) controls[--liveTo]->hidden = true;
+        stale = liveFrom > 0 || liveTo < n;
+    }
+
+    // После раскладки все rect верны: дети по порядку, окно находится двоичным поиском
+    void findLive() {
+        const size_t n = controls.size();
+        for (size_t i = liveFrom; i < liveTo && i < n; ++i) controls[i]->hidden = true;
+        if (direction != Vertical) {
+            liveFrom = 0;
+            liveTo = n;
+        } else {
+            const SMALL_RECT view = viewport();
+            auto first = std::partition_point(controls.begin(), controls.end(), [&](const std::shared_ptr<Control>& c) { return c->rect.Bottom < view.Top; });
+            auto last = std::partition_point(first, controls.end(), [&](const std::shared_ptr<Control>& c) { return c->rect.Top <= view.Bottom; });
+            liveFrom = static_cast<size_t>(first - controls.begin());
+            liveTo = static_cast<size_t>(last - controls.begin());
+            if (liveFrom == liveTo && n > 0) {
+                liveTo = (std::min)(liveFrom + 1, n);    // Опора для следующей прокрутки
+                liveFrom = liveTo - 1;
+            }
+        }
+        const SMALL_RECT view = viewport();
+        for (size_t i = liveFrom; i < liveTo; ++i) controls[i]->hidden = !Render::intersects(controls[i]->rect, view);
+    }
+
     void drawScrollbar() {
         if (maxScroll <= 0) return;
-        
+
         short x = rect.Right;
         short height = rect.Bottom - rect.Top - 1;
         if (height <= 0) return;
 
         // Рисуем "дорожку"
-        for (short y = 0; y <= height; ++y) {
-            Render::drawChar({x, (short)(rect.Top + y)}, L'░', 0x08);
-        }
+        Render::fillRect({x, rect.Top, x, (short)(rect.Top + height)}, L'░', 0x08);
 
         // Рисуем "ползунок"
-        short thumbPos = (scrollY * height) / (maxScroll + height);
+        short thumbPos = static_cast<short>((scrollY * height) / (maxScroll + height));
         Render::drawChar({x, (short)(rect.Top + thumbPos)}, L'█', 0x07);
     }
-};
\ No newline at end of file
+};
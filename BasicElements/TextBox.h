@@ -1,18 +1,16 @@
 
 #pragma once
-#include <windows.h>
+#include "../Core/Platform.h"
 #include "../Core/Control.h"
 #include "../Core/Render.h"
 // ------------------ TextBox ------------------
 class TextBox : public Control, public Render {
-std::shared_ptr<std::function<void(const KEY_EVENT_RECORD&)>> handler;
+HandlerId<KEY_EVENT_RECORD> handler;
 bool redmode = false;
 public:
     std::wstring text;
     TextBox(SMALL_RECT r, const std::wstring t) : Control(r), text(t) {
-        EventManager::getInstance().addHandler<MOUSE_EVENT_RECORD>([this](const MOUSE_EVENT_RECORD& mer) {
-            this->onMouse(mer);
-        });
+        MouseRouter::add(this);
     }
 
     void draw() override {
@@ -52,7 +50,7 @@ public:
     void unsubscribeKeyboard() {
         if (!handler) return;
         EventManager::getInstance().removeHandler<KEY_EVENT_RECORD>(handler);
-        handler.reset();
+        handler = {};
     }
 
     void onKey(const KEY_EVENT_RECORD& ker) override {
@@ -63,7 +61,7 @@ public:
             else if (ker.wVirtualKeyCode == VK_BACK && !text.empty()) {
                 text.pop_back();
             }      
-            draw();
+            invalidate();
         }
     }
 
@@ -0,0 +1,136 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include <climits>
+#include "ScrollContainer.h"
+
+// ------------------ VirtualScrollContainer ------------------
+// Вертикальный список из itemCount() элементов одной высоты, которые не живут в памяти все сразу:
+// строками-элементами управления представлены только видимые элементы и по overscan с каждой стороны.
+// Строку создаёт factory, bind(строка, номер) наполняет её данными элемента. Элемент i всегда
+// показывает строка i % размер пула: при прокрутке строка, ушедшая за край, достаётся элементу,
+// появившемуся с другого края, и перепривязываются только новые элементы.
+// Прокрутка, раскладка и отрисовка - O(видимых строк), от числа элементов не зависят.
+// itemHeight - высота строки как у rect (Bottom - Top), между строками spacing.
+class VirtualScrollContainer : public ScrollContainer {
+public:
+    using Factory = std::function<std::shared_ptr<Control>()>;
+    using Binder = std::function<void(Control&, size_t)>;
+
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    short itemHeight;
+    size_t overscan {2};
+
+    VirtualScrollContainer(SMALL_RECT r, short height, Factory make, Binder bind)
+        : ScrollContainer(r, Vertical), itemHeight(height), factory(std::move(make)), binder(std::move(bind)) {}
+
+    size_t itemCount() const { return count; }
+
+    void setItemCount(size_t n) {
+        count = n;
+        refresh();
+    }
+
+    // Данные элементов изменились - живые строки привязываются заново
+    void refresh() {
+        std::fill(bound.begin(), bound.end(), none);
+        realize();
+        invalidate();
+    }
+
+    // Прокрутить на lines строк экрана (вниз - больше нуля): строки встают на места,
+    // нарисованное сдвигается блоком (ScrollContainer::scrolled)
+    void scrollBy(int lines) override {
+        int target = (std::clamp)(scrollY + lines, 0, maxScroll);
+        if (target == scrollY) return;
+        int dy = scrollY - target;
+        scrollY = target;
+        realize();
+        scrolled(dy);
+    }
+
+    // Элемент index - первой строкой (насколько позволяет конец списка)
+    void scrollTo(size_t index) {
+        long long target = static_cast<long long>(index) * stride();
+        scrollBy(static_cast<int>((std::min)(target, static_cast<long long>(maxScroll)) - scrollY));
+    }
+
+    // Первый хотя бы частично видимый элемент
+    size_t firstVisible() const { return count == 0 ? 0 : static_cast<size_t>(scrollY / stride()); }
+
+    // Элемент, который показывает строка; none - строка не из этого списка
+    size_t itemOf(const Control& row) const {
+        if (row.parent != this || row.childIndex < 0 || static_cast<size_t>(row.childIndex) >= bound.size()) return none;
+        return bound[row.childIndex];
+    }
+
+protected:
+    // Смена размера или полная раскладка: пул под новую высоту, строки на места
+    SMALL_RECT arrangeChildren(size_t, size_t) override { return realize(); }
+
+    // maxScroll считает realize() по числу элементов, а не по живым строкам
+    void arranged() override {}
+
+private:
+    Factory factory;
+    Binder binder;
+    size_t count {0};
+    std::vector<size_t> bound;      // Элемент, привязанный к строке пула
+
+    // itemHeight и spacing открыты: нулевые (или отрицательные) не должны дать шаг 0 - на него делят
+    int stride() const { return (std::max)(1, itemHeight + spacing); }
+
+    SMALL_RECT realize() {
+        SMALL_RECT damage { 0, 0, -1, -1 };
+        const int viewport = mainAvailable();
+        const long long content = count == 0 ? 0 : static_cast<long long>(count) * stride() - spacing;
+        maxScroll = static_cast<int>((std::clamp)(content - viewport, 0LL, static_cast<long long>(INT_MAX)));
+        scrollY = (std::clamp)(scrollY, 0, maxScroll);
+
+        // Видимые строки (две - частично) и overscan с каждой стороны
+        const size_t rows = (std::min)(count, static_cast<size_t>((std::max)(viewport, 0) / stride() + 2) + 2 * overscan);
+        if (rows != controls.size()) resizePool(rows);
+        liveFrom = 0;
+        liveTo = rows;
+        if (rows == 0) return damage;
+
+        const size_t first = static_cast<size_t>(scrollY / stride());
+        const size_t start = (std::min)(first > overscan ? first - overscan : 0, count - rows);
+        const SMALL_RECT view = ScrollContainer::viewport();
+        const long long top = static_cast<long long>(view.Top) - scrollY;
+        for (size_t i = start; i < start + rows; ++i) {
+            const size_t slot = i % rows;
+            Control& row = *controls[slot];
+            if (bound[slot] != i) {
+                binder(row, i);
+                bound[slot] = i;
+            }
+            SHORT y = static_cast<SHORT>(top + static_cast<long long>(i) * stride());
+            place(row, { view.Left, y, view.Right, static_cast<SHORT>(y + itemHeight) }, damage);
+            row.hidden = !Render::intersects(row.rect, view);    // Строки overscan не рисуются
+        }
+        return damage;
+    }
+
+    // Размер пула сменился - у всех элементов сменилась строка (i % rows), привязка заново
+    void resizePool(size_t rows) {
+        while (controls.size() > rows) {
+            Control* row = controls.back().get();
+            resized.erase(std::remove(resized.begin(), resized.end(), row), resized.end());
+            nested.erase(std::remove(nested.begin(), nested.end(), row), nested.end());
+            row->parent = nullptr;
+            row->childIndex = -1;
+            controls.pop_back();
+        }
+        while (controls.size() < rows) {
+            std::shared_ptr<Control> row = factory();
+            row->parent = this;
+            row->childIndex = static_cast<int>(controls.size());
+            row->measureDirty = false;  // Высота строки - itemHeight
+            controls.push_back(row);
+        }
+        bound.assign(rows, none);
+    }
+};
@@ -0,0 +1,223 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "Platform.h"
+#include "Cell.h"
+
+// Кодировщик ячеек в минимальный поток ANSI/VT.
+// Помнит, что уже показано в терминале, текущую позицию курсора и текущий SGR-атрибут:
+// - совпадающие с экраном ячейки пропускаются;
+// - SGR выдаётся только для изменившейся части (фон и/или цвет текста);
+// - до следующей ячейки курсор ведётся самым коротким способом: CUP, относительный сдвиг,
+//   \r или повторный вывод уже показанных ячеек промежутка.
+class AnsiEncoder {
+private:
+    std::string out;
+    COORD size {0, 0};
+    std::vector<Cell> shown;    // Что сейчас на терминале
+    COORD cursor {0, 0};
+    bool cursorKnown {false};   // После вывода в последний столбец позиция зависит от терминала
+    WORD sgr {0};
+    bool sgrKnown {false};
+
+public:
+    // С этой длины серия пробелов стирается ECH (\x1b[nX) вместо вывода самих пробелов
+    SHORT eraseMin {8};
+    // REP (\x1b[nb) повторяет предыдущий символ; есть в xterm и Windows Terminal, но не везде
+    bool useRepeat {false};
+
+    explicit AnsiEncoder(COORD s = { 0, 0 }) { resize(s); }
+
+    void resize(COORD s) {
+        size = s;
+        shown.assign(static_cast<size_t>(s.X) * s.Y, Cell{});
+        invalidate();
+    }
+
+    // Состояние терминала неизвестно (например, после вывода в обход кодировщика)
+    void invalidate() {
+        cursorKnown = false;
+        sgrKnown = false;
+    }
+
+    std::string& buffer() { return out; }
+
+    void clear(WORD attr) {
+        setAttr(attr);
+        out += "\x1b[2J";
+        std::fill(shown.begin(), shown.end(), Cell{ L' ', attr });
+    }
+
+    // Строки top..bottom сдвигаются на dy (вниз - больше нуля): область прокрутки DECSTBM и SU/SD.
+    // Открывшиеся строки терминал стирает текущим фоном - перед сдвигом он ставится по attr.
+    void scrollRows(SHORT top, SHORT bottom, SHORT dy, WORD attr) {
+        top = (std::max)(top, SHORT(0));
+        bottom = (std::min)(bottom, static_cast<SHORT>(size.Y - 1));
+        if (dy == 0 || bottom < top) return;
+        setAttr(attr);
+        out += "\x1b[" + std::to_string(top + 1) + ";" + std::to_string(bottom + 1) + "r";
+        out += "\x1b[" + std::to_string(std::abs(dy)) + (dy > 0 ? "T" : "S");
+        out += "\x1b[r";
+        cursorKnown = false;    // DECSTBM ставит курсор в начало экрана
+        const size_t width = static_cast<size_t>(size.X);
+        for (int i = 0; i <= bottom - top; ++i) {
+            SHORT y = static_cast<SHORT>(dy > 0 ? bottom - i : top + i);
+            int from = y - dy;
+            if (from >= top && from <= bottom) std::copy_n(&at(0, static_cast<SHORT>(from)), width, &at(0, y));
+            else std::fill_n(&at(0, y), width, Cell{ L' ', attr });
+        }
+    }
+
+    void encodeRun(COORD pos, const Cell* cells, SHORT length) {
+        if (pos.Y < 0 || pos.Y >= size.Y) return;
+        for (SHORT i = 0; i < length; ++i) {
+            SHORT x = pos.X + i;
+            if (x < 0 || x >= size.X) continue;
+            if (at(x, pos.Y) == cells[i]) continue;
+            if (cells[i].flags & Cell::WideTrail) {
+                at(x, pos.Y) = cells[i]; // Выведена вместе с левой половиной
+                continue;
+            }
+            moveTo({ x, pos.Y });
+
+            // Серия одинаковых ячеек: пробелы стираются ECH, прочее можно повторить REP
+            SHORT same = 1;
+            while (i + same < length && x + same < size.X && cells[i + same] == cells[i]) ++same;
+            if (cells[i].ch == L' ' && same >= eraseMin) {
+                setAttr(cells[i].attr);
+                out += "\x1b[" + std::to_string(same) + "X"; // Курсор остаётся на месте
+                std::fill_n(&at(x, pos.Y), same, cells[i]);
+                i += same - 1;
+                continue;
+            }
+            emit(cells[i]);
+            at(x, pos.Y) = cells[i];
+            if (useRepeat && same > 1 && cursorKnown) {
+                std::string rep = "\x1b[" + std::to_string(same - 1) + "b";
+                if (rep.size() < (same - 1) * utf8Length(cells[i].ch)) {
+                    out += rep;
+                    std::fill_n(&at(x, pos.Y), same, cells[i]);
+                    if (x + same >= size.X) cursorKnown = false;
+                    else cursor.X = x + same;
+                    i += same - 1;
+                }
+            }
+        }
+    }
+
+    void moveTo(COORD target) {
+        if (cursorKnown && cursor.X == target.X && cursor.Y == target.Y) return;
+
+        // Кандидат 1: абсолютная позиция всегда работает
+        std::string best = cup(target);
+        if (cursorKnown) {
+            // Кандидат 2: относительный сдвиг по строкам и столбцам
+            std::string relative = verticalMove(target.Y - cursor.Y) + horizontalMove(target.X - cursor.X);
+            if (relative.size() < best.size()) best = std::move(relative);
+
+            // Кандидат 3: возврат каретки в начало строки и сдвиг вправо
+            if (target.X < cursor.X) {
+                std::string cr = verticalMove(target.Y - cursor.Y) + "\r" + horizontalMove(target.X);
+                if (cr.size() < best.size()) best = std::move(cr);
+            }
+
+            // Кандидат 4: на той же строке перепечатать промежуток, он уже на экране
+            if (target.Y == cursor.Y && target.X > cursor.X && !(at(cursor.X, target.Y).flags & Cell::WideTrail)) {
+                size_t gapBytes = 0;
+                bool sameAttr = true;
+                for (SHORT x = cursor.X; x < target.X && sameAttr && gapBytes < best.size(); ++x) {
+                    const Cell& gap = at(x, target.Y);
+                    sameAttr = sgrKnown && gap.attr == sgr;
+                    if (!(gap.flags & Cell::WideTrail)) gapBytes += utf8Length(gap.ch);
+                }
+                if (sameAttr && gapBytes < best.size()) {
+                    for (SHORT x = cursor.X; x < target.X; ++x) {
+                        const Cell& gap = at(x, target.Y);
+                        if (!(gap.flags & Cell::WideTrail)) appendUtf8(out, gap.ch);
+                    }
+                    cursor = target;
+                    return;
+                }
+            }
+        }
+        out += best;
+        cursor = target;
+        cursorKnown = true;
+    }
+
+    // Атрибут консоли Windows -> параметры SGR. В WinAPI биты идут BGR, в ANSI - RGB.
+    static int ansiForeground(WORD attr) { return ((attr & FOREGROUND_INTENSITY) ? 90 : 30) + ansiColor(attr & 0x07); }
+    static int ansiBackground(WORD attr) { return ((attr & BACKGROUND_INTENSITY) ? 100 : 40) + ansiColor((attr >> 4) & 0x07); }
+
+    static size_t utf8Length(wchar_t wc) {
+        char32_t c = static_cast<char32_t>(wc);
+        return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+    }
+
+    static void appendUtf8(std::string& s, wchar_t wc) {
+        char32_t c = static_cast<char32_t>(wc);
+        if (c >= 0xD800 && c <= 0xDFFF) c = U'?'; // Суррогаты UTF-16 по одному не кодируются
+        if (c < 0x80) {
+            s += static_cast<char>(c);
+        } else if (c < 0x800) {
+            s += static_cast<char>(0xC0 | (c >> 6));
+            s += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            s += static_cast<char>(0xE0 | (c >> 12));
+            s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            s += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            s += static_cast<char>(0xF0 | (c >> 18));
+            s += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            s += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+private:
+    Cell& at(SHORT x, SHORT y) { return shown[static_cast<size_t>(y) * size.X + x]; }
+
+    static int ansiColor(WORD bits) { return ((bits & 4) ? 1 : 0) | ((bits & 2) ? 2 : 0) | ((bits & 1) ? 4 : 0); }
+
+    void emit(const Cell& cell) {
+        setAttr(cell.attr);
+        appendUtf8(out, cell.ch);
+        // В последнем столбце терминал откладывает перенос, позицию дальше не угадать
+        SHORT advance = (cell.flags & Cell::WideLead) ? 2 : 1;
+        if (cursor.X + advance >= size.X) cursorKnown = false;
+        else cursor.X += advance;
+    }
+
+    // SGR только для изменившихся составляющих
+    void setAttr(WORD attr) {
+        bool fg = !sgrKnown || ansiForeground(attr) != ansiForeground(sgr);
+        bool bg = !sgrKnown || ansiBackground(attr) != ansiBackground(sgr);
+        sgr = attr;
+        sgrKnown = true;
+        if (!fg && !bg) return;
+        out += "\x1b[";
+        if (fg) out += std::to_string(ansiForeground(attr));
+        if (fg && bg) out += ';';
+        if (bg) out += std::to_string(ansiBackground(attr));
+        out += 'm';
+    }
+
+    static std::string cup(COORD target) {
+        if (target.X == 0 && target.Y == 0) return "\x1b[H";
+        if (target.X == 0) return "\x1b[" + std::to_string(target.Y + 1) + "H";
+        return "\x1b[" + std::to_string(target.Y + 1) + ";" + std::to_string(target.X + 1) + "H";
+    }
+
+    static std::string move(int n, char forward, char backward) {
+        if (n == 0) return {};
+        char code = n > 0 ? forward : backward;
+        int count = n > 0 ? n : -n;
+        if (count == 1) return std::string("\x1b[") + code;
+        return "\x1b[" + std::to_string(count) + code;
+    }
+
+    static std::string verticalMove(int dy) { return move(dy, 'B', 'A'); }
+    static std::string horizontalMove(int dx) { return move(dx, 'C', 'D'); }
+};
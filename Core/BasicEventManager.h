@@ -0,0 +1,400 @@
+#pragma once
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <iostream>
+#include "Platform.h"
+#include <algorithm>
+#include <chrono>
+#include "HandlerContainer.h"
+#include "SpscQueue.h"
+#include "InputSource.h"
+#include "InputCoalescer.h"
+#include "InputLanes.h"
+#include "LatencyTracker.h"
+
+// Конвейер ввода без привязки к элементам управления: что происходит вокруг кадра диспетчера,
+// решает Host. EventManager.h подставляет UiHost (uiMutex, Render::Frame, FrameScheduler, MouseRouter),
+// headeronly/core.h - ConsoleHost.
+//   static std::recursive_mutex& mutex();         - под ним вызываются обработчики
+//   using Frame = ...;                             - RAII на кадр диспетчера
+//   static void route(const MOUSE_EVENT_RECORD&);  - до обработчиков мыши
+//   static void redraw();                          - ввод разобран или кадр упёрся в бюджет полос
+struct ConsoleHost {
+    static std::recursive_mutex& mutex() {
+        static std::recursive_mutex m;
+        return m;
+    }
+    struct Frame {};
+    static void route(const MOUSE_EVENT_RECORD&) {}
+    static void redraw() {}
+};
+
+// Счётчики конвейера ввода; пишутся потоками конвейера, читаются откуда угодно
+struct InputStats {
+    std::atomic<size_t> read {0};           // Записей получено от источника
+    std::atomic<size_t> dispatched {0};     // Записей разобрано диспетчером (включая слитые)
+    std::atomic<size_t> batches {0};        // Кадров диспетчера (один кадр - один Host::Frame)
+    std::atomic<size_t> maxDepth {0};       // Наибольшая глубина очереди
+    std::atomic<size_t> readerStalls {0};   // Очередь была полна, поток чтения ждал
+    std::atomic<size_t> maxBacklog {0};     // Наибольший остаток в полосах после кадра (InputLanes)
+    std::atomic<size_t> mergedMoves {0};    // Записей, поглощённых слиянием (InputCoalescer и хвост Motion)
+    std::atomic<size_t> mergedWheels {0};
+    std::atomic<size_t> mergedResizes {0};
+    std::atomic<long long> enqueueNs {0};   // Время потока чтения на постановку в очередь (без ожидания источника)
+    std::atomic<long long> dispatchNs {0};  // Время диспетчера в обработчиках и кадрах
+};
+
+// Ввод идёт в две стадии:
+// - поток чтения только забирает сырые записи у InputSource и кладёт их в SPSC-очередь;
+// - поток диспетчера разбирает очередь пачками, сливает в пачке соседние движения мыши
+//   и прокрутки (InputCoalescer), раскладывает записи по полосам приоритета (InputLanes)
+//   и вызывает обработчики под Host::mutex() кадрами: клавиши - первыми, движения - по бюджету.
+// Медленный draw() задерживает диспетчер, но не чтение: записи копятся в очереди, а не в консоли.
+// Каждая запись в очереди помечена моментом чтения - по нему LatencyTracker считает задержку
+// до обработчиков и до кадра на экране.
+// Locking - стратегия блокировки списков обработчиков (см. HandlerContainer.h), Host - см. выше.
+template <typename Locking = LockFree, typename Host = ConsoleHost>
+class BasicEventManager {
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr DWORD readBatch = 128;
+
+    struct QueuedInput {
+        INPUT_RECORD record;
+        long long readNs;       // LatencyTracker::now() в момент, когда источник отдал запись
+    };
+
+    std::thread readerThread;
+    std::thread dispatchThread;
+    std::atomic<bool> running;
+    std::atomic<bool> readerDone {false};
+    std::atomic<unsigned> published {0};    // Растёт, когда в очереди появились записи или пора остановиться
+    std::atomic<bool> exitRequested {false};    // Будит run(): requestExit() или конец ввода
+    std::atomic<bool> inRun {false};            // Идёт run()
+
+    ConsoleInputSource console;
+    InputSource* source {&console};
+    SpscQueue<QueuedInput, 1024> queue;
+    InputCoalescer coalescer;
+    InputLanes inputLanes;
+    InputStats stats;
+
+    // Контейнеры для каждого типа событий winAPI, другие не нужны.
+    HandlerContainer<KEY_EVENT_RECORD, Locking> keyHandlers;
+    HandlerContainer<MOUSE_EVENT_RECORD, Locking> mouseHandlers;
+    HandlerContainer<FOCUS_EVENT_RECORD, Locking> focusHandlers;
+    HandlerContainer<MENU_EVENT_RECORD, Locking> menuHandlers;
+    HandlerContainer<WINDOW_BUFFER_SIZE_RECORD, Locking> windowBufferSizeHandlers;
+    HandlerContainer<INPUT_RECORD, Locking> inputHandlers; // Пользователь хочет получать все события
+
+    BasicEventManager() : running(false) {}
+    ~BasicEventManager() { stop(); }
+
+    void wake() {
+        published.fetch_add(1, std::memory_order_release);
+        published.notify_one();
+    }
+
+    // Стадия 1: источник -> очередь
+    void readerLoop() {
+        INPUT_RECORD records[readBatch];
+        while (running) {
+            DWORD count = 0;
+            if (!source->read(records, readBatch, count)) break; // Источник закрыт или ошибка чтения
+
+            auto start = Clock::now();
+            long long readNs = LatencyTracker::enabled ? LatencyTracker::now() : 0;
+            for (DWORD i = 0; i < count && running; ) {
+                if (queue.push({ records[i], readNs })) {
+                    ++i;
+                    continue;
+                }
+                // Очередь полна: диспетчер не успевает, ждём его, а не теряем ввод
+                stats.readerStalls++;
+                wake();
+                std::this_thread::yield();
+            }
+            stats.read += count;
+            size_t depth = queue.size();
+            if (depth > stats.maxDepth) stats.maxDepth = depth;
+            stats.enqueueNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            wake();
+        }
+        readerDone = true;
+        wake();
+    }
+
+    // Стадия 2: очередь -> обработчики
+    void dispatchLoop() {
+        INPUT_RECORD batch[readBatch];
+        long long readNs[readBatch];
+        while (running) {
+            unsigned seen = published.load(std::memory_order_acquire);
+            size_t n = take(batch, readNs);
+            std::unique_lock<std::recursive_mutex> lock(Host::mutex());
+            if (n == 0 && inputLanes.empty()) {
+                lock.unlock();
+                if (!readerDone) {
+                    published.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+                // readerDone ставится после последней записи - проверяем очередь ещё раз
+                if ((n = take(batch, readNs)) == 0) break;
+                lock.lock();
+            }
+            // Новые записи - в полосы до кадра, чтобы клавиша из свежей пачки обогнала старые движения
+            if (n) enqueueBatch(batch, n, readNs);
+            dispatchFrame();
+        }
+        // Источник закрыт и всё разобрано (или stop() во время run()) - run() больше ждать нечего.
+        // stop() вне run() запроса на выход не оставляет
+        if (running || inRun) {
+            exitRequested = true;
+            exitRequested.notify_all();
+        }
+    }
+
+    // Пачка из очереди: всё, что накопилось, но не больше readBatch
+    size_t take(INPUT_RECORD* batch, long long* readNs) {
+        size_t n = 0;
+        QueuedInput input;
+        while (n < readBatch && queue.pop(input)) {
+            batch[n] = input.record;
+            readNs[n++] = input.readNs;
+        }
+        return n;
+    }
+
+    // Обработчик может вызвать stop() из потока конвейера - себя такой поток не ждёт
+    static void join(std::thread& thread) {
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) thread.join();
+    }
+
+    // Слияние соседних записей пачки и раскладка по полосам
+    void enqueueBatch(INPUT_RECORD* batch, size_t n, long long* readNs) {
+        auto start = Clock::now();
+        CoalesceCounts merged;
+        size_t count = coalescer.apply(batch, n, merged, readNs);
+        addMerged(merged);
+        for (size_t i = 0; i < count; ++i) inputLanes.push(batch[i], readNs ? readNs[i] : 0);
+        stats.dispatched += n;
+        stats.dispatchNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    // Кадр: записи полос в порядке приоритета и в пределах бюджетов, всё нарисованное - одним Host::Frame
+    void dispatchFrame() {
+        bool live = running;    // stop() посреди кадра прерывает его, только если конвейер работал
+        auto start = Clock::now();
+        {
+            [[maybe_unused]] typename Host::Frame frame;
+            CoalesceCounts merged;
+            inputLanes.frame([&](const INPUT_RECORD& record, long long readNs) {
+                if (!running && live) return;
+                if (readNs) LatencyTracker::beginInput(record.EventType, readNs);
+                dispatch(record);
+                LatencyTracker::endInput();
+            }, merged);
+            addMerged(merged);
+            stats.batches++;
+            size_t backlog = inputLanes.size();
+            if (backlog > stats.maxBacklog) stats.maxBacklog = backlog;
+
+            // Перерисовка, когда очередь ввода разобрана до конца или кадр упёрся в бюджет полос
+            if (queue.empty() || backlog) Host::redraw();
+        }
+        stats.dispatchNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    void addMerged(const CoalesceCounts& merged) {
+        stats.mergedMoves += merged.moves;
+        stats.mergedWheels += merged.wheels;
+        stats.mergedResizes += merged.resizes;
+    }
+
+public:
+    // Пачка записей так же, как её разбирает поток диспетчера: слияние, полосы, обработчики
+    // кадрами до конца пачки и перерисовка (Host::redraw). Вызывать под Host::mutex().
+    // Без запущенных потоков - детерминированное воспроизведение ввода (TraceInputSource, bench_replay).
+    // readNs - моменты чтения записей (LatencyTracker::now()); без них задержка считается от вызова.
+    void dispatchBatch(INPUT_RECORD* batch, size_t n, long long* readNs = nullptr) {
+        long long handedNs[readBatch];
+        if (!readNs && n <= readBatch) {
+            std::fill_n(handedNs, n, LatencyTracker::enabled ? LatencyTracker::now() : 0);
+            readNs = handedNs;
+        }
+        bool live = running;
+        enqueueBatch(batch, n, readNs);
+        do dispatchFrame(); while (!inputLanes.empty() && (running || !live));
+    }
+
+    // Раздаёт одно событие обработчикам его типа (используется циклом и бенчмарками)
+    void dispatch(const INPUT_RECORD& record) {
+        switch (record.EventType) {
+            case KEY_EVENT:
+                keyHandlers.invokeHandlers(record.Event.KeyEvent);
+            break;
+            case MOUSE_EVENT:
+                Host::route(record.Event.MouseEvent);
+                mouseHandlers.invokeHandlers(record.Event.MouseEvent);
+            break;
+            case FOCUS_EVENT:
+                focusHandlers.invokeHandlers(record.Event.FocusEvent);
+            break;
+            case MENU_EVENT:
+                menuHandlers.invokeHandlers(record.Event.MenuEvent);
+            break;
+            case WINDOW_BUFFER_SIZE_EVENT:
+                windowBufferSizeHandlers.invokeHandlers(record.Event.WindowBufferSizeEvent);
+            break;
+        }
+        // inputHandlers.invokeHandlers(record);
+    }
+
+    // Получение экземпляра менеджера событий (Singleton)
+    static BasicEventManager& getInstance() {
+        static BasicEventManager instance;
+        return instance;
+    }
+
+    void clearAllHandlers() {
+        keyHandlers.clearHandlers();
+        mouseHandlers.clearHandlers();
+        focusHandlers.clearHandlers();
+        menuHandlers.clearHandlers();
+        windowBufferSizeHandlers.clearHandlers();
+        inputHandlers.clearHandlers();
+    }
+
+    // Добавление обработчиков для каждого типа событий
+    template <typename T>
+    inline HandlerId<T> addHandler(Handler<T> handler) {
+        if constexpr (std::is_same_v<T, KEY_EVENT_RECORD>) {
+            return keyHandlers.addHandler(std::move(handler));
+        } else if constexpr (std::is_same_v<T, MOUSE_EVENT_RECORD>) {
+            return mouseHandlers.addHandler(std::move(handler));
+        } else if constexpr (std::is_same_v<T, FOCUS_EVENT_RECORD>) {
+            return focusHandlers.addHandler(std::move(handler));
+        } else if constexpr (std::is_same_v<T, MENU_EVENT_RECORD>) {
+            return menuHandlers.addHandler(std::move(handler));
+        } else if constexpr (std::is_same_v<T, WINDOW_BUFFER_SIZE_RECORD>) {
+            return windowBufferSizeHandlers.addHandler(std::move(handler));
+        } else if constexpr (std::is_same_v<T, INPUT_RECORD>) {
+            return inputHandlers.addHandler(std::move(handler));
+        }
+    }
+
+    template <typename T>
+    inline bool removeHandler(HandlerId<T> id) {
+        if constexpr (std::is_same_v<T, KEY_EVENT_RECORD>) {
+            return keyHandlers.removeHandler(id);
+        } else if constexpr (std::is_same_v<T, MOUSE_EVENT_RECORD>) {
+            return mouseHandlers.removeHandler(id);
+        } else if constexpr (std::is_same_v<T, FOCUS_EVENT_RECORD>) {
+            return focusHandlers.removeHandler(id);
+        } else if constexpr (std::is_same_v<T, MENU_EVENT_RECORD>) {
+            return menuHandlers.removeHandler(id);
+        } else if constexpr (std::is_same_v<T, WINDOW_BUFFER_SIZE_RECORD>) {
+            return windowBufferSizeHandlers.removeHandler(id);
+        } else if constexpr (std::is_same_v<T, INPUT_RECORD>) {
+            return inputHandlers.removeHandler(id);
+        }
+    }
+
+    template <typename T>
+    inline void clearAllHandlers() {
+        if constexpr (std::is_same_v<T, KEY_EVENT_RECORD>) {
+            keyHandlers.clearHandlers();
+        } else if constexpr (std::is_same_v<T, MOUSE_EVENT_RECORD>) {
+             mouseHandlers.clearHandlers();
+        } else if constexpr (std::is_same_v<T, FOCUS_EVENT_RECORD>) {
+             focusHandlers.clearHandlers();
+        } else if constexpr (std::is_same_v<T, MENU_EVENT_RECORD>) {
+             menuHandlers.clearHandlers();
+        } else if constexpr (std::is_same_v<T, WINDOW_BUFFER_SIZE_RECORD>) {
+             windowBufferSizeHandlers.clearHandlers();
+        } else if constexpr (std::is_same_v<T, INPUT_RECORD>) {
+             inputHandlers.clearHandlers();
+        }
+    }
+
+    // Источник ввода вместо консоли (например, ScriptedInputSource); nullptr - снова консоль.
+    // Меняется только при остановленном менеджере.
+    void setInputSource(InputSource* s) {
+        if (running) return;
+        source = s ? s : &console;
+    }
+
+    // Политика слияния записей пачки по типам; менять до start()
+    InputCoalescer& coalescing() { return coalescer; }
+
+    // Полосы приоритета и их бюджеты на кадр; менять до start()
+    InputLanes& lanes() { return inputLanes; }
+
+    const InputStats& inputStats() const { return stats; }
+    size_t queueDepth() const { return queue.size(); }
+
+    void resetInputStats() {
+        stats.read = 0;
+        stats.dispatched = 0;
+        stats.batches = 0;
+        stats.maxDepth = 0;
+        stats.readerStalls = 0;
+        stats.maxBacklog = 0;
+        stats.mergedMoves = 0;
+        stats.mergedWheels = 0;
+        stats.mergedResizes = 0;
+        stats.enqueueNs = 0;
+        stats.dispatchNs = 0;
+    }
+
+    // Запуск обработчика событий
+    void start() { // Разрешаем повторный запуск.
+        if (running) return;
+        join(readerThread);     // Потоки прошлого запуска, если stop() звали из них самих
+        join(dispatchThread);
+        source->restart();
+        inputLanes.clear();     // Остаток прошлого запуска, прерванного stop()
+        running = true;
+        readerDone = false;
+        readerThread = std::thread([this]() { this->readerLoop(); });
+        dispatchThread = std::thread([this]() { this->dispatchLoop(); });
+    }
+
+    // Остановка обработчика событий
+    void stop() { // мягко прерываем поток.
+        if (running.exchange(false)) source->cancel();  // Поток чтения ждёт в source->read() - будим
+        wake();
+        join(dispatchThread);
+        join(readerThread);
+    }
+
+    // Главный цикл программы: запускает конвейер и блокирует вызывающий поток без опроса,
+    // пока не вызван requestExit() или источник ввода не закончился; затем останавливает конвейер.
+    // requestExit() до run() не теряется: run() сразу возвращается. Запрос гасится, когда run() вернулся.
+    //   em.addHandler<KEY_EVENT_RECORD>([&](const KEY_EVENT_RECORD& k) {
+    //       if (k.bKeyDown && k.wVirtualKeyCode == VK_ESCAPE) em.requestExit();
+    //   });
+    //   em.run();
+    void run() {
+        inRun = true;
+        if (!exitRequested) {
+            start();
+            exitRequested.wait(false);
+        }
+        stop();
+        inRun = false;
+        exitRequested = false;
+    }
+
+    // Из обработчика или любого потока: run() вернётся, как только конвейер остановится.
+    // Поток чтения будится сразу, не дожидаясь следующего ввода.
+    void requestExit() {
+        exitRequested = true;
+        exitRequested.notify_all();
+        source->cancel();
+    }
+};
+
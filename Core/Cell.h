@@ -0,0 +1,25 @@
+#pragma once
+#include <cwchar>
+#include <type_traits>
+#include "Platform.h"
+
+// Ячейка экрана: символ + атрибут, как CHAR_INFO в консоли.
+// Ровно 8 байт без дыр выравнивания на любой платформе: буферы кадров сравниваются
+// целыми словами и SIMD-регистрами (Core/CellDiff.h), а мусор в padding дал бы ложные отличия.
+struct alignas(8) Cell {
+    wchar_t ch {L' '};
+    WORD attr {FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE};
+    WORD flags {0};         // WideLead / WideTrail
+#if WCHAR_MAX <= 0xFFFF
+    WORD reserved {0};      // wchar_t 16-битный (Windows): добиваем до 8 байт
+#endif
+
+    // Символ двойной ширины (CharWidth::of == 2) занимает две ячейки с одинаковым ch
+    static constexpr WORD WideLead = 0x0001;    // Левая половина - здесь символ выводится
+    static constexpr WORD WideTrail = 0x0002;   // Правая половина - её закрывает WideLead
+
+    bool operator==(const Cell&) const = default;
+};
+
+static_assert(sizeof(Cell) == 8, "Cell must be exactly 8 bytes");
+static_assert(std::has_unique_object_representations_v<Cell>, "Cell must not contain padding");
@@ -0,0 +1,169 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include "Cell.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CELLDIFF_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define CELLDIFF_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Сравнение двух буферов ячеек (кадр и то, что уже на экране).
+// Cell - ровно 8 байт без padding, поэтому ячейки сравниваются как 64-битные слова:
+// скалярно по одной, SSE2 - по 2, AVX2 - по 4 за сравнение.
+// Набор инструкций выбирается при компиляции (-march=native / /arch:AVX2), kernel можно сменить для замеров.
+namespace CellDiff {
+
+enum class Kernel { Scalar, SSE2, AVX2 };
+
+constexpr Kernel best() {
+#if defined(CELLDIFF_AVX2)
+    return Kernel::AVX2;
+#elif defined(CELLDIFF_SSE2)
+    return Kernel::SSE2;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+constexpr bool supported(Kernel k) {
+    switch (k) {
+        case Kernel::AVX2:
+#if defined(CELLDIFF_AVX2)
+            return true;
+#else
+            return false;
+#endif
+        case Kernel::SSE2:
+#if defined(CELLDIFF_SSE2)
+            return true;
+#else
+            return false;
+#endif
+        default: return true;
+    }
+}
+
+constexpr const char* name(Kernel k) {
+    switch (k) {
+        case Kernel::AVX2: return "avx2";
+        case Kernel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+inline Kernel kernel = best();
+
+inline std::uint64_t word(const Cell* c) {
+    std::uint64_t w;
+    std::memcpy(&w, c, sizeof(w));
+    return w;
+}
+
+// Индекс первой ячейки, где a != b (Differ = true) или a == b (Differ = false); n, если такой нет
+template <bool Differ>
+inline size_t scanScalar(const Cell* a, const Cell* b, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if ((word(a + i) != word(b + i)) == Differ) return i;
+    }
+    return n;
+}
+
+#if defined(CELLDIFF_SSE2)
+// Маска равенства ячеек: без SSE4.1 нет сравнения 64-битных слов, поэтому ячейка равна,
+// если равны обе её 32-битные половины (сравнение AND сравнение с переставленными половинами)
+inline __m128i equalCellsSse2(const Cell* a, const Cell* b) {
+    __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+template <bool Differ>
+inline size_t scanSse2(const Cell* a, const Cell* b, size_t n) {
+    size_t i = 0;
+    // Блоками по 8 ячеек (64 байта): одна проверка на блок, точное место ищется только при попадании
+    for (; i + 8 <= n; i += 8) {
+        __m128i e0 = equalCellsSse2(a + i, b + i);
+        __m128i e1 = equalCellsSse2(a + i + 2, b + i + 2);
+        __m128i e2 = equalCellsSse2(a + i + 4, b + i + 4);
+        __m128i e3 = equalCellsSse2(a + i + 6, b + i + 6);
+        __m128i all = Differ ? _mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3))
+                             : _mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3));
+        int mask = _mm_movemask_epi8(all);
+        if (Differ ? mask != 0xFFFF : mask != 0) break;
+    }
+    for (; i + 2 <= n; i += 2) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(equalCellsSse2(a + i, b + i)));
+        unsigned same = (mask & 1) | ((mask >> 7) & 2);   // По биту на ячейку
+        unsigned hit = Differ ? (~same & 0x3) : same;
+        if (hit) return i + ((hit & 1) ? 0 : 1);
+    }
+    return i + scanScalar<Differ>(a + i, b + i, n - i);
+}
+#endif
+
+#if defined(CELLDIFF_AVX2)
+inline unsigned equalCellsAvx2(const Cell* a, const Cell* b) {
+    __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+}
+
+template <bool Differ>
+inline size_t scanAvx2(const Cell* a, const Cell* b, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned same = equalCellsAvx2(a + i, b + i) | (equalCellsAvx2(a + i + 4, b + i + 4) << 4);
+        unsigned hit = Differ ? (~same & 0xFF) : same;
+        if (hit) return i + static_cast<size_t>(std::countr_zero(hit));
+    }
+    for (; i + 4 <= n; i += 4) {
+        unsigned same = equalCellsAvx2(a + i, b + i);
+        unsigned hit = Differ ? (~same & 0xF) : same;
+        if (hit) return i + static_cast<size_t>(std::countr_zero(hit));
+    }
+    return i + scanScalar<Differ>(a + i, b + i, n - i);
+}
+#endif
+
+template <bool Differ>
+inline size_t scan(const Cell* a, const Cell* b, size_t n) {
+    switch (kernel) {
+#if defined(CELLDIFF_AVX2)
+        case Kernel::AVX2: return scanAvx2<Differ>(a, b, n);
+#endif
+#if defined(CELLDIFF_SSE2)
+        case Kernel::SSE2: return scanSse2<Differ>(a, b, n);
+#endif
+        default: return scanScalar<Differ>(a, b, n);
+    }
+}
+
+inline size_t findDiff(const Cell* a, const Cell* b, size_t n) { return scan<true>(a, b, n); }
+inline size_t findSame(const Cell* a, const Cell* b, size_t n) { return scan<false>(a, b, n); }
+
+// Отрезки строки, где back отличается от front: emit(start, end) с end не включительно.
+// Отрезки, разделённые не более чем mergeGap совпадающими ячейками, склеиваются в один.
+template <typename Emit>
+inline void forEachRun(const Cell* back, const Cell* front, size_t n, size_t mergeGap, Emit&& emit) {
+    size_t x = findDiff(back, front, n);
+    while (x < n) {
+        size_t start = x;
+        size_t end;
+        for (;;) {
+            end = x + 1 + findSame(back + x + 1, front + x + 1, n - x - 1);
+            if (end >= n) { x = n; break; }
+            x = end + findDiff(back + end, front + end, n - end);
+            if (x >= n || x - end > mergeGap) break;
+        }
+        emit(start, end);
+    }
+}
+
+} // namespace CellDiff
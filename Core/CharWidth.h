@@ -0,0 +1,245 @@
+#pragma once
+#include <array>
+#include <iterator>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Ширина символа в ячейках консоли: 0 (комбинируемые знаки, управляющие, невидимые),
+// 1 (обычные) или 2 (East Asian Wide/Fullwidth, эмодзи).
+// Таблица двухуровневая и строится при компиляции из списка диапазонов:
+// stage1 - по байту на блок из 256 кодов (0/1/2 - весь блок одной ширины, иначе номер смешанного блока),
+// stage2 - смешанные блоки, по 2 бита на код. Для ASCII таблица не нужна вовсе.
+namespace CharWidth {
+
+struct Range {
+    char32_t first;
+    char32_t last;
+};
+
+// Комбинируемые знаки и символы нулевой ширины
+inline constexpr Range zeroWidth[] = {
+    { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 },
+    { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0610, 0x061A }, { 0x064B, 0x065F }, { 0x0670, 0x0670 },
+    { 0x06D6, 0x06DC }, { 0x06DF, 0x06E4 }, { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED }, { 0x0711, 0x0711 },
+    { 0x0730, 0x074A }, { 0x07A6, 0x07B0 }, { 0x07EB, 0x07F3 }, { 0x0816, 0x082D }, { 0x0859, 0x085B },
+    { 0x08D3, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C }, { 0x0941, 0x0948 }, { 0x094D, 0x094D },
+    { 0x0951, 0x0957 }, { 0x0962, 0x0963 }, { 0x0981, 0x0981 }, { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 },
+    { 0x09CD, 0x09CD }, { 0x09E2, 0x09E3 }, { 0x0A01, 0x0A02 }, { 0x0A3C, 0x0A3C }, { 0x0A41, 0x0A51 },
+    { 0x0A70, 0x0A71 }, { 0x0A75, 0x0A75 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC }, { 0x0AC1, 0x0AC8 },
+    { 0x0ACD, 0x0ACD }, { 0x0AE2, 0x0AE3 }, { 0x0B01, 0x0B01 }, { 0x0B3C, 0x0B3C }, { 0x0B3F, 0x0B3F },
+    { 0x0B41, 0x0B44 }, { 0x0B4D, 0x0B4D }, { 0x0B56, 0x0B56 }, { 0x0B62, 0x0B63 }, { 0x0B82, 0x0B82 },
+    { 0x0BC0, 0x0BC0 }, { 0x0BCD, 0x0BCD }, { 0x0C00, 0x0C00 }, { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C56 },
+    { 0x0C62, 0x0C63 }, { 0x0CBC, 0x0CBC }, { 0x0CCC, 0x0CCD }, { 0x0CE2, 0x0CE3 }, { 0x0D00, 0x0D01 },
+    { 0x0D41, 0x0D44 }, { 0x0D4D, 0x0D4D }, { 0x0D62, 0x0D63 }, { 0x0DCA, 0x0DCA }, { 0x0DD2, 0x0DD6 },
+    { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E }, { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EBC },
+    { 0x0EC8, 0x0ECD }, { 0x0F18, 0x0F19 }, { 0x0F35, 0x0F35 }, { 0x0F37, 0x0F37 }, { 0x0F39, 0x0F39 },
+    { 0x0F71, 0x0F7E }, { 0x0F80, 0x0F84 }, { 0x0F86, 0x0F87 }, { 0x0F8D, 0x0FBC }, { 0x0FC6, 0x0FC6 },
+    { 0x102D, 0x1030 }, { 0x1032, 0x1037 }, { 0x1039, 0x103A }, { 0x103D, 0x103E }, { 0x1058, 0x1059 },
+    { 0x1160, 0x11FF }, { 0x135D, 0x135F }, { 0x1712, 0x1714 }, { 0x1732, 0x1734 }, { 0x1752, 0x1753 },
+    { 0x1772, 0x1773 }, { 0x17B4, 0x17B5 }, { 0x17B7, 0x17BD }, { 0x17C6, 0x17C6 }, { 0x17C9, 0x17D3 },
+    { 0x17DD, 0x17DD }, { 0x180B, 0x180E }, { 0x18A9, 0x18A9 }, { 0x1920, 0x1922 }, { 0x1927, 0x1928 },
+    { 0x1932, 0x1932 }, { 0x1939, 0x193B }, { 0x1A17, 0x1A18 }, { 0x1A1B, 0x1A1B }, { 0x1A56, 0x1A56 },
+    { 0x1A58, 0x1A60 }, { 0x1A65, 0x1A6C }, { 0x1A73, 0x1A7F }, { 0x1AB0, 0x1AFF }, { 0x1B00, 0x1B03 },
+    { 0x1B34, 0x1B34 }, { 0x1B36, 0x1B3A }, { 0x1B6B, 0x1B73 }, { 0x1DC0, 0x1DFF }, { 0x200B, 0x200F },
+    { 0x202A, 0x202E }, { 0x2060, 0x2064 }, { 0x20D0, 0x20F0 }, { 0x2CEF, 0x2CF1 }, { 0x2DE0, 0x2DFF },
+    { 0x302A, 0x302D }, { 0x3099, 0x309A }, { 0xA66F, 0xA672 }, { 0xA674, 0xA67D }, { 0xA69E, 0xA69F },
+    { 0xA6F0, 0xA6F1 }, { 0xA802, 0xA802 }, { 0xA806, 0xA806 }, { 0xA80B, 0xA80B }, { 0xA825, 0xA826 },
+    { 0xA8C4, 0xA8C5 }, { 0xA8E0, 0xA8F1 }, { 0xA926, 0xA92D }, { 0xA947, 0xA951 }, { 0xD7B0, 0xD7FF },
+    { 0xFB1E, 0xFB1E }, { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F }, { 0xFEFF, 0xFEFF }, { 0xFFF9, 0xFFFB },
+    { 0x101FD, 0x101FD }, { 0x10A01, 0x10A0F }, { 0x10A38, 0x10A3F }, { 0x11001, 0x11001 }, { 0x11038, 0x11046 },
+    { 0x1D167, 0x1D169 }, { 0x1D173, 0x1D182 }, { 0x1D185, 0x1D18B }, { 0x1D1AA, 0x1D1AD }, { 0x1F3FB, 0x1F3FF },
+};
+
+// East Asian Wide и Fullwidth, эмодзи в представлении по умолчанию
+inline constexpr Range doubleWidth[] = {
+    { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC }, { 0x23F0, 0x23F0 },
+    { 0x23F3, 0x23F3 }, { 0x25FD, 0x25FE }, { 0x2614, 0x2615 }, { 0x2648, 0x2653 }, { 0x267F, 0x267F },
+    { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 }, { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 },
+    { 0x26CE, 0x26CE }, { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA }, { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 },
+    { 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B }, { 0x2728, 0x2728 },
+    { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 }, { 0x2757, 0x2757 }, { 0x2795, 0x2797 },
+    { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF }, { 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 },
+    { 0x2E80, 0x3029 }, { 0x302E, 0x303E }, { 0x3041, 0x3098 }, { 0x309B, 0x33FF }, { 0x3400, 0x4DBF },
+    { 0x4E00, 0x9FFF }, { 0xA000, 0xA4CF }, { 0xA960, 0xA97F }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF },
+    { 0xFE10, 0xFE19 }, { 0xFE30, 0xFE6F }, { 0xFF00, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 },
+    { 0x17000, 0x18CFF }, { 0x1B000, 0x1B2FF }, { 0x1F004, 0x1F004 }, { 0x1F0CF, 0x1F0CF }, { 0x1F18E, 0x1F18E },
+    { 0x1F191, 0x1F19A }, { 0x1F200, 0x1F251 }, { 0x1F300, 0x1F320 }, { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C },
+    { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA }, { 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 },
+    { 0x1F3F8, 0x1F3FA }, { 0x1F400, 0x1F43E }, { 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D },
+    { 0x1F54B, 0x1F54E }, { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A }, { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 },
+    { 0x1F5FB, 0x1F64F }, { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 }, { 0x1F6D5, 0x1F6D7 },
+    { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC }, { 0x1F7E0, 0x1F7EB }, { 0x1F90C, 0x1F93A }, { 0x1F93C, 0x1F945 },
+    { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FAFF }, { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD },
+};
+
+// Таблица покрывает плоскости 0-3; выше - только теги и селекторы вариантов (нулевая ширина)
+inline constexpr char32_t tableLimit = 0x40000;
+inline constexpr size_t blockCount = tableLimit >> 8;
+
+namespace detail {
+
+// Ширина по спискам диапазонов: медленно, для проверок
+constexpr int slowWidth(char32_t c) {
+    for (const Range& r : zeroWidth) if (c >= r.first && c <= r.last) return 0;
+    for (const Range& r : doubleWidth) if (c >= r.first && c <= r.last) return 2;
+    return 1;
+}
+
+constexpr bool sorted(const Range* ranges, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (ranges[i].first > ranges[i].last) return false;
+        if (i > 0 && ranges[i - 1].last >= ranges[i].first) return false;
+    }
+    return true;
+}
+static_assert(sorted(zeroWidth, std::size(zeroWidth)) && sorted(doubleWidth, std::size(doubleWidth)),
+              "width ranges must be sorted and disjoint");
+
+// Курсор по отсортированному списку диапазонов: блоки обходятся по возрастанию,
+// поэтому на весь обход приходится O(блоков + диапазонов) сравнений
+struct Cursor {
+    const Range* ranges;
+    size_t count;
+    size_t at {0};
+
+    // Ширина w, если диапазоны накрывают блок целиком; 1 - не задевают; -1 - задевают частично
+    constexpr int classify(char32_t first, char32_t last, int w) {
+        while (at < count && ranges[at].last < first) ++at;
+        if (at == count || ranges[at].first > last) return 1;
+        if (ranges[at].first <= first && ranges[at].last >= last) return w;
+        return -1;
+    }
+};
+
+// Ширина блока, если она у всех 256 кодов одинакова, иначе -1
+constexpr int uniformWidth(Cursor& zero, Cursor& wide, size_t block) {
+    const char32_t first = static_cast<char32_t>(block << 8);
+    const char32_t last = first + 0xFF;
+    int z = zero.classify(first, last, 0);
+    int d = wide.classify(first, last, 2);
+    if (z == 0) return 0;               // Нулевая ширина важнее двойной (как в slowWidth)
+    if (z < 0) return -1;
+    return d;                           // Диапазонов нулевой ширины в блоке нет
+}
+
+constexpr size_t countMixed() {
+    Cursor zero { zeroWidth, std::size(zeroWidth) };
+    Cursor wide { doubleWidth, std::size(doubleWidth) };
+    size_t n = 0;
+    for (size_t b = 0; b < blockCount; ++b) n += uniformWidth(zero, wide, b) < 0;
+    return n;
+}
+
+inline constexpr size_t mixedCount = countMixed();
+static_assert(mixedCount + 3 <= 256, "stage1 stores block numbers in one byte");
+
+struct Tables {
+    std::array<std::uint8_t, blockCount> stage1 {};
+    std::array<std::uint8_t, mixedCount * 64> stage2 {};
+};
+
+// Записывает ширину w для пересечения диапазона r со смешанным блоком
+constexpr void paint(Tables& t, size_t mixed, size_t block, const Range& r, int w) {
+    const char32_t first = static_cast<char32_t>(block << 8);
+    const char32_t last = first + 0xFF;
+    if (r.first > last || r.last < first) return;
+    const size_t from = (r.first > first ? r.first : first) - first;
+    const size_t to = (r.last < last ? r.last : last) - first;
+    for (size_t i = from; i <= to; ++i) {
+        std::uint8_t& packed = t.stage2[mixed * 64 + i / 4];
+        const int shift = static_cast<int>(i % 4) * 2;
+        packed = static_cast<std::uint8_t>((packed & ~(3 << shift)) | (w << shift));
+    }
+}
+
+constexpr Tables build() {
+    Tables t;
+    Cursor zero { zeroWidth, std::size(zeroWidth) };
+    Cursor wide { doubleWidth, std::size(doubleWidth) };
+    size_t mixed = 0;
+    for (size_t b = 0; b < blockCount; ++b) {
+        int w = uniformWidth(zero, wide, b);
+        if (w >= 0) {
+            t.stage1[b] = static_cast<std::uint8_t>(w);
+            continue;
+        }
+        t.stage1[b] = static_cast<std::uint8_t>(3 + mixed);
+        for (size_t i = 0; i < 64; ++i) t.stage2[mixed * 64 + i] = 0x55; // Ширина 1 у всех четырёх кодов
+        // Нулевая ширина важнее двойной, поэтому рисуется последней
+        for (size_t i = wide.at; i < wide.count && doubleWidth[i].first <= ((b << 8) | 0xFF); ++i) paint(t, mixed, b, doubleWidth[i], 2);
+        for (size_t i = zero.at; i < zero.count && zeroWidth[i].first <= ((b << 8) | 0xFF); ++i) paint(t, mixed, b, zeroWidth[i], 0);
+        ++mixed;
+    }
+    return t;
+}
+
+inline constexpr Tables tables = build();
+
+} // namespace detail
+
+// Ширина одного кода Unicode
+constexpr int of(char32_t c) {
+    if (c < 0x7F) return c >= 0x20 ? 1 : 0;     // ASCII: без таблицы
+    if (c < 0xA0) return 0;                     // DEL и управляющие C1
+    if (c >= tableLimit) return (c >= 0xE0000 && c <= 0xE0FFF) ? 0 : 1;
+    std::uint8_t block = detail::tables.stage1[c >> 8];
+    if (block < 3) return block;
+    return (detail::tables.stage2[(block - 3) * 64 + (c & 0xFF) / 4] >> ((c & 3) * 2)) & 3;
+}
+
+// Можно ли вводить символ в текстовое поле: всё, кроме управляющих
+constexpr bool isPrintable(char32_t c) {
+    return c >= 0x20 && !(c >= 0x7F && c < 0xA0);
+}
+
+// Следующий код из wchar_t-строки: на Windows wchar_t - UTF-16, суррогатные пары склеиваются.
+// units - сколько wchar_t занял код.
+inline char32_t decode(const wchar_t* s, size_t n, size_t& units) {
+    char32_t c = static_cast<char32_t>(s[0]);
+    units = 1;
+    if constexpr (sizeof(wchar_t) == 2) {
+        if (c >= 0xD800 && c <= 0xDBFF && n > 1) {
+            char32_t low = static_cast<char32_t>(s[1]);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                units = 2;
+                return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+            }
+        }
+    }
+    return c;
+}
+
+// Ширина строки в ячейках
+inline size_t measure(const wchar_t* s, size_t n) {
+    size_t width = 0;
+    size_t i = 0;
+    // Быстрый путь: пока идёт печатный ASCII, ширина - это длина
+    while (i < n && s[i] >= 0x20 && s[i] < 0x7F) ++i;
+    width = i;
+    while (i < n) {
+        size_t units;
+        width += static_cast<size_t>(of(decode(s + i, n - i, units)));
+        i += units;
+    }
+    return width;
+}
+
+inline size_t measure(const std::wstring& s) { return measure(s.data(), s.size()); }
+
+// Сколько wchar_t с начала строки помещается в columns ячеек; width - их ширина
+inline size_t fit(const wchar_t* s, size_t n, size_t columns, size_t* width = nullptr) {
+    size_t used = 0;
+    size_t i = 0;
+    while (i < n) {
+        size_t units;
+        size_t w = static_cast<size_t>(of(decode(s + i, n - i, units)));
+        if (used + w > columns) break;
+        used += w;
+        i += units;
+    }
+    if (width) *width = used;
+    return i;
+}
+
+} // namespace CharWidth
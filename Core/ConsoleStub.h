@@ -0,0 +1,392 @@
+#pragma once
+// Консоль-заглушка для сборки без Windows.
+// Повторяет ту часть WinAPI, которой пользуется библиотека: типы, константы и функции
+// вывода в консоль. Экран хранится в памяти, а каждый вызов API считается в ConsoleStub::stats,
+// поэтому количество "системных вызовов" и время перерисовки можно измерить на Linux.
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+typedef int            BOOL;
+typedef unsigned char  BYTE;
+typedef unsigned short WORD;
+typedef uint32_t       DWORD;
+typedef short          SHORT;
+typedef long           LONG;
+typedef unsigned int   UINT;
+typedef char           CHAR;
+typedef wchar_t        WCHAR;
+typedef wchar_t        TCHAR;
+typedef void*          HANDLE;
+typedef void*          HWND;
+
+#define TRUE  1
+#define FALSE 0
+
+typedef struct _COORD { SHORT X; SHORT Y; } COORD;
+typedef struct _SMALL_RECT { SHORT Left; SHORT Top; SHORT Right; SHORT Bottom; } SMALL_RECT;
+typedef struct tagPOINT { LONG x; LONG y; } POINT;
+
+typedef struct _CHAR_INFO {
+    union { WCHAR UnicodeChar; CHAR AsciiChar; } Char;
+    WORD Attributes;
+} CHAR_INFO;
+
+typedef struct _CONSOLE_SCREEN_BUFFER_INFO {
+    COORD dwSize;
+    COORD dwCursorPosition;
+    WORD wAttributes;
+    SMALL_RECT srWindow;
+    COORD dwMaximumWindowSize;
+} CONSOLE_SCREEN_BUFFER_INFO;
+
+typedef struct _KEY_EVENT_RECORD {
+    BOOL bKeyDown;
+    WORD wRepeatCount;
+    WORD wVirtualKeyCode;
+    WORD wVirtualScanCode;
+    union { WCHAR UnicodeChar; CHAR AsciiChar; } uChar;
+    DWORD dwControlKeyState;
+} KEY_EVENT_RECORD;
+
+typedef struct _MOUSE_EVENT_RECORD {
+    COORD dwMousePosition;
+    DWORD dwButtonState;
+    DWORD dwControlKeyState;
+    DWORD dwEventFlags;
+} MOUSE_EVENT_RECORD;
+
+typedef struct _WINDOW_BUFFER_SIZE_RECORD { COORD dwSize; } WINDOW_BUFFER_SIZE_RECORD;
+typedef struct _MENU_EVENT_RECORD { UINT dwCommandId; } MENU_EVENT_RECORD;
+typedef struct _FOCUS_EVENT_RECORD { BOOL bSetFocus; } FOCUS_EVENT_RECORD;
+
+typedef struct _INPUT_RECORD {
+    WORD EventType;
+    union {
+        KEY_EVENT_RECORD KeyEvent;
+        MOUSE_EVENT_RECORD MouseEvent;
+        WINDOW_BUFFER_SIZE_RECORD WindowBufferSizeEvent;
+        MENU_EVENT_RECORD MenuEvent;
+        FOCUS_EVENT_RECORD FocusEvent;
+    } Event;
+} INPUT_RECORD;
+
+// Атрибуты символов
+#define FOREGROUND_BLUE      0x0001
+#define FOREGROUND_GREEN     0x0002
+#define FOREGROUND_RED       0x0004
+#define FOREGROUND_INTENSITY 0x0008
+#define BACKGROUND_BLUE      0x0010
+#define BACKGROUND_GREEN     0x0020
+#define BACKGROUND_RED       0x0040
+#define BACKGROUND_INTENSITY 0x0080
+#define COMMON_LVB_LEADING_BYTE  0x0100
+#define COMMON_LVB_TRAILING_BYTE 0x0200
+
+// Стандартные дескрипторы
+#define STD_INPUT_HANDLE     ((DWORD)-10)
+#define STD_OUTPUT_HANDLE    ((DWORD)-11)
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+
+// Ожидание объектов
+#define INFINITE      0xFFFFFFFF
+#define WAIT_OBJECT_0 0x00000000
+#define WAIT_TIMEOUT  0x00000102
+#define WAIT_FAILED   ((DWORD)0xFFFFFFFF)
+
+// Типы событий ввода
+#define KEY_EVENT                0x0001
+#define MOUSE_EVENT              0x0002
+#define WINDOW_BUFFER_SIZE_EVENT 0x0004
+#define MENU_EVENT               0x0008
+#define FOCUS_EVENT              0x0010
+
+// Мышь
+#define FROM_LEFT_1ST_BUTTON_PRESSED 0x0001
+#define RIGHTMOST_BUTTON_PRESSED     0x0002
+#define MOUSE_MOVED                  0x0001
+#define DOUBLE_CLICK                 0x0002
+#define MOUSE_WHEELED                0x0004
+#define MOUSE_HWHEELED               0x0008
+#define WHEEL_DELTA                  120
+
+// Режимы консоли
+#define ENABLE_PROCESSED_INPUT 0x0001
+#define ENABLE_WINDOW_INPUT    0x0008
+#define ENABLE_MOUSE_INPUT     0x0010
+#define ENABLE_EXTENDED_FLAGS  0x0080
+
+// Виртуальные клавиши
+#define VK_LBUTTON  0x01
+#define VK_RBUTTON  0x02
+#define VK_MBUTTON  0x04
+#define VK_BACK     0x08
+#define VK_TAB      0x09
+#define VK_RETURN   0x0D
+#define VK_SHIFT    0x10
+#define VK_ESCAPE   0x1B
+#define VK_SPACE    0x20
+#define VK_LEFT     0x25
+#define VK_UP       0x26
+#define VK_RIGHT    0x27
+#define VK_DOWN     0x28
+#define VK_NUMPAD0  0x60
+#define VK_NUMPAD1  0x61
+#define VK_NUMPAD2  0x62
+#define VK_NUMPAD3  0x63
+#define VK_NUMPAD4  0x64
+#define VK_NUMPAD5  0x65
+#define VK_NUMPAD6  0x66
+#define VK_NUMPAD7  0x67
+#define VK_NUMPAD8  0x68
+#define VK_NUMPAD9  0x69
+#define VK_MULTIPLY 0x6A
+#define VK_ADD      0x6B
+#define VK_SUBTRACT 0x6D
+#define VK_DECIMAL  0x6E
+#define VK_DIVIDE   0x6F
+#define VK_F9       0x78
+#define VK_F10      0x79
+
+#define LOWORD(l) ((WORD)(((DWORD)(l)) & 0xffff))
+#define HIWORD(l) ((WORD)((((DWORD)(l)) >> 16) & 0xffff))
+
+namespace ConsoleStub {
+    struct Stats {
+        size_t calls {0};        // Вызовы функций консольного API
+        size_t cellsWritten {0}; // Ячейки, реально изменённые этими вызовами
+    };
+
+    inline Stats stats;
+    inline COORD size {120, 40};
+    inline COORD cursor {0, 0};
+    inline WORD defaultAttr {FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE};
+    inline std::vector<CHAR_INFO> screen;
+    inline short keyState[256] {};
+    inline std::deque<INPUT_RECORD> input; // Заранее подготовленные события для ReadConsoleInput
+
+    // Объект-событие CreateEvent; все события ждут на одной паре мьютекс/условная переменная
+    struct Event {
+        bool manualReset;
+        bool signaled;
+    };
+    inline std::mutex eventMutex;
+    inline std::condition_variable eventSignal;
+
+    // Дескрипторы GetStdHandle - маленькие числа, всё остальное - события
+    inline Event* asEvent(HANDLE h) { return reinterpret_cast<intptr_t>(h) > 2 ? static_cast<Event*>(h) : nullptr; }
+
+    inline void resetStats() { stats = {}; }
+
+    inline void ensureScreen() {
+        size_t cells = static_cast<size_t>(size.X) * size.Y;
+        if (screen.size() == cells) return;
+        CHAR_INFO blank {};
+        blank.Char.UnicodeChar = L' ';
+        blank.Attributes = defaultAttr;
+        screen.assign(cells, blank);
+    }
+
+    // Линейный индекс ячейки; WinAPI пишет строки подряд, перенося вывод на следующую строку.
+    inline size_t indexOf(COORD pos) { return static_cast<size_t>(pos.Y) * size.X + pos.X; }
+
+    inline bool valid(COORD pos) { return pos.X >= 0 && pos.Y >= 0 && pos.X < size.X && pos.Y < size.Y; }
+
+    // Сколько ячеек из length реально поместится в буфер начиная с pos
+    inline DWORD clampLength(COORD pos, DWORD length) {
+        if (!valid(pos)) return 0;
+        return static_cast<DWORD>((std::min)(static_cast<size_t>(length), screen.size() - indexOf(pos)));
+    }
+}
+
+inline HANDLE GetStdHandle(DWORD nStdHandle) {
+    return reinterpret_cast<HANDLE>(static_cast<intptr_t>(nStdHandle == STD_OUTPUT_HANDLE ? 1 : 2));
+}
+
+inline BOOL WriteConsoleOutputCharacterW(HANDLE, const WCHAR* chars, DWORD length, COORD pos, DWORD* written) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::ensureScreen();
+    DWORD n = ConsoleStub::clampLength(pos, length);
+    CHAR_INFO* dst = ConsoleStub::screen.data() + ConsoleStub::indexOf(pos);
+    for (DWORD i = 0; i < n; ++i) dst[i].Char.UnicodeChar = chars[i];
+    ConsoleStub::stats.cellsWritten += n;
+    if (written) *written = n;
+    return TRUE;
+}
+
+inline BOOL FillConsoleOutputAttribute(HANDLE, WORD attr, DWORD length, COORD pos, DWORD* written) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::ensureScreen();
+    DWORD n = ConsoleStub::clampLength(pos, length);
+    CHAR_INFO* dst = ConsoleStub::screen.data() + ConsoleStub::indexOf(pos);
+    for (DWORD i = 0; i < n; ++i) dst[i].Attributes = attr;
+    ConsoleStub::stats.cellsWritten += n;
+    if (written) *written = n;
+    return TRUE;
+}
+
+inline BOOL FillConsoleOutputCharacterW(HANDLE, WCHAR ch, DWORD length, COORD pos, DWORD* written) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::ensureScreen();
+    DWORD n = ConsoleStub::clampLength(pos, length);
+    CHAR_INFO* dst = ConsoleStub::screen.data() + ConsoleStub::indexOf(pos);
+    for (DWORD i = 0; i < n; ++i) dst[i].Char.UnicodeChar = ch;
+    ConsoleStub::stats.cellsWritten += n;
+    if (written) *written = n;
+    return TRUE;
+}
+#define FillConsoleOutputCharacter FillConsoleOutputCharacterW
+
+inline BOOL WriteConsoleOutputW(HANDLE, const CHAR_INFO* buffer, COORD bufferSize, COORD bufferCoord, SMALL_RECT* region) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::ensureScreen();
+    SHORT left   = std::max<SHORT>(region->Left, 0);
+    SHORT top    = std::max<SHORT>(region->Top, 0);
+    SHORT right  = std::min<SHORT>(region->Right, ConsoleStub::size.X - 1);
+    SHORT bottom = std::min<SHORT>(region->Bottom, ConsoleStub::size.Y - 1);
+    for (SHORT y = top; y <= bottom; ++y) {
+        const CHAR_INFO* src = buffer + static_cast<size_t>(bufferCoord.Y + y - region->Top) * bufferSize.X + (bufferCoord.X + left - region->Left);
+        std::copy(src, src + (right - left + 1), ConsoleStub::screen.data() + ConsoleStub::indexOf({ left, y }));
+    }
+    if (right >= left && bottom >= top) ConsoleStub::stats.cellsWritten += static_cast<size_t>(right - left + 1) * (bottom - top + 1);
+    *region = { left, top, right, bottom };
+    return TRUE;
+}
+
+// Сдвиг прямоугольника scroll в dest; пишется только внутрь clip, освободившееся заливается fill
+inline BOOL ScrollConsoleScreenBufferW(HANDLE, const SMALL_RECT* scroll, const SMALL_RECT* clip, COORD dest, const CHAR_INFO* fill) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::ensureScreen();
+    SMALL_RECT bounds = clip ? *clip : SMALL_RECT{ 0, 0, static_cast<SHORT>(ConsoleStub::size.X - 1), static_cast<SHORT>(ConsoleStub::size.Y - 1) };
+    bounds.Left = std::max<SHORT>(bounds.Left, 0);
+    bounds.Top = std::max<SHORT>(bounds.Top, 0);
+    bounds.Right = std::min<SHORT>(bounds.Right, ConsoleStub::size.X - 1);
+    bounds.Bottom = std::min<SHORT>(bounds.Bottom, ConsoleStub::size.Y - 1);
+    std::vector<CHAR_INFO> before = ConsoleStub::screen;
+    const SHORT dx = dest.X - scroll->Left, dy = dest.Y - scroll->Top;
+    for (SHORT y = bounds.Top; y <= bounds.Bottom; ++y) {
+        for (SHORT x = bounds.Left; x <= bounds.Right; ++x) {
+            SHORT sx = x - dx, sy = y - dy;
+            bool inside = sx >= scroll->Left && sx <= scroll->Right && sy >= scroll->Top && sy <= scroll->Bottom;
+            bool vacated = x >= scroll->Left && x <= scroll->Right && y >= scroll->Top && y <= scroll->Bottom;
+            if (inside) ConsoleStub::screen[ConsoleStub::indexOf({ x, y })] = before[ConsoleStub::indexOf({ sx, sy })];
+            else if (vacated) ConsoleStub::screen[ConsoleStub::indexOf({ x, y })] = *fill;
+            else continue;
+            ConsoleStub::stats.cellsWritten++;
+        }
+    }
+    return TRUE;
+}
+
+inline BOOL GetConsoleScreenBufferInfo(HANDLE, CONSOLE_SCREEN_BUFFER_INFO* info) {
+    ConsoleStub::stats.calls++;
+    info->dwSize = ConsoleStub::size;
+    info->dwCursorPosition = ConsoleStub::cursor;
+    info->wAttributes = ConsoleStub::defaultAttr;
+    info->srWindow = { 0, 0, static_cast<SHORT>(ConsoleStub::size.X - 1), static_cast<SHORT>(ConsoleStub::size.Y - 1) };
+    info->dwMaximumWindowSize = ConsoleStub::size;
+    return TRUE;
+}
+
+inline BOOL SetConsoleCursorPosition(HANDLE, COORD pos) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::cursor = pos;
+    return TRUE;
+}
+
+inline BOOL SetConsoleScreenBufferSize(HANDLE, COORD size) {
+    ConsoleStub::stats.calls++;
+    ConsoleStub::size = size;
+    ConsoleStub::screen.clear();
+    ConsoleStub::ensureScreen();
+    return TRUE;
+}
+
+inline BOOL SetConsoleWindowInfo(HANDLE, BOOL, const SMALL_RECT*) {
+    ConsoleStub::stats.calls++;
+    return TRUE;
+}
+
+inline BOOL GetConsoleMode(HANDLE, DWORD* mode) { *mode = 0; return TRUE; }
+inline BOOL SetConsoleMode(HANDLE, DWORD) { return TRUE; }
+
+// Отдаёт события из ConsoleStub::input. Пустая очередь считается закрытой консолью.
+inline BOOL ReadConsoleInputW(HANDLE, INPUT_RECORD* buffer, DWORD length, DWORD* read) {
+    if (ConsoleStub::input.empty()) return FALSE;
+    DWORD n = 0;
+    while (n < length && !ConsoleStub::input.empty()) {
+        buffer[n++] = ConsoleStub::input.front();
+        ConsoleStub::input.pop_front();
+    }
+    *read = n;
+    return TRUE;
+}
+#define ReadConsoleInput ReadConsoleInputW
+
+inline HANDLE CreateEventW(void*, BOOL manualReset, BOOL initialState, const WCHAR*) {
+    return new ConsoleStub::Event { manualReset != 0, initialState != 0 };
+}
+#define CreateEvent CreateEventW
+
+inline BOOL SetEvent(HANDLE h) {
+    ConsoleStub::Event* event = ConsoleStub::asEvent(h);
+    if (!event) return FALSE;
+    {
+        std::lock_guard<std::mutex> lock(ConsoleStub::eventMutex);
+        event->signaled = true;
+    }
+    ConsoleStub::eventSignal.notify_all();
+    return TRUE;
+}
+
+inline BOOL ResetEvent(HANDLE h) {
+    ConsoleStub::Event* event = ConsoleStub::asEvent(h);
+    if (!event) return FALSE;
+    std::lock_guard<std::mutex> lock(ConsoleStub::eventMutex);
+    event->signaled = false;
+    return TRUE;
+}
+
+inline BOOL CloseHandle(HANDLE h) {
+    delete ConsoleStub::asEvent(h);
+    return TRUE;
+}
+
+// Только ожидание любого из объектов (waitAll не поддержан). Консольный ввод всегда готов:
+// в нём есть события или он закрыт (ReadConsoleInput вернёт FALSE)
+inline DWORD WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL, DWORD milliseconds) {
+    std::unique_lock<std::mutex> lock(ConsoleStub::eventMutex);
+    DWORD result = WAIT_TIMEOUT;
+    auto ready = [&] {
+        for (DWORD i = 0; i < count; ++i) {
+            ConsoleStub::Event* event = ConsoleStub::asEvent(handles[i]);
+            if (event && !event->signaled) continue;
+            if (event && !event->manualReset) event->signaled = false;
+            result = WAIT_OBJECT_0 + i;
+            return true;
+        }
+        return false;
+    };
+    if (milliseconds == INFINITE) ConsoleStub::eventSignal.wait(lock, ready);
+    else ConsoleStub::eventSignal.wait_for(lock, std::chrono::milliseconds(milliseconds), ready);
+    return result;
+}
+
+inline DWORD WaitForSingleObject(HANDLE h, DWORD milliseconds) { return WaitForMultipleObjects(1, &h, FALSE, milliseconds); }
+
+inline BOOL GetNumberOfConsoleInputEvents(HANDLE, DWORD* count) {
+    *count = static_cast<DWORD>(ConsoleStub::input.size());
+    return TRUE;
+}
+
+inline SHORT GetKeyState(int vkey) { return ConsoleStub::keyState[vkey & 0xff]; }
+inline SHORT GetAsyncKeyState(int vkey) { return ConsoleStub::keyState[vkey & 0xff]; }
+
+inline BOOL GetCursorPos(POINT* p) { *p = { 0, 0 }; return TRUE; }
+inline HWND GetConsoleWindow() { return nullptr; }
+inline BOOL ScreenToClient(HWND, POINT*) { return TRUE; }
@@ -1,10 +1,84 @@
 #include "Control.h"
+#include "FrameScheduler.h"
+#include "MouseRouter.h"
 
 Control::Control(SMALL_RECT r)
     : rect(r) {}
 
+Control::~Control() {
+    FrameScheduler::cancel(this);
+    MouseRouter::remove(this);
+}
+
+void Control::setRect(const SMALL_RECT& r) {
+    bool resized = r.Right - r.Left != rect.Right - rect.Left || r.Bottom - r.Top != rect.Bottom - rect.Top;
+    arrange(r);     // Контейнер заодно переставляет детей
+    if (resized) requestLayout();
+}
+
+COORD Control::measure() {
+    return { static_cast<SHORT>(rect.Right - rect.Left), static_cast<SHORT>(rect.Bottom - rect.Top) };
+}
+
+void Control::arrange(const SMALL_RECT& r) {
+    rect = r;
+    MouseRouter::update(this);
+}
+
+void Control::requestLayout() {
+    measureDirty = true;
+    if (!parent) return;
+    parent->childLayoutChanged(*this);
+    parent->markLayoutDirty();
+}
+
+void Control::markLayoutDirty() {
+    Control* node = this;
+    while (!node->layoutDirty) {
+        node->layoutDirty = true;
+        if (!node->parent) {
+            FrameScheduler::scheduleLayout(node);
+            return;
+        }
+        node->parent->childLayoutChanged(*node);
+        node = node->parent;
+    }
+}
+
+void Control::invalidate() {
+    FrameScheduler::invalidate(this, rect);
+}
+
+void Control::invalidate(const SMALL_RECT& area) {
+    FrameScheduler::invalidate(this, area);
+}
+
+void Control::paint(const SMALL_RECT& clip) {
+    (void)clip;
+    FrameScheduler::stats.visits++;
+    draw();
+}
+
+Control* Control::visibleRoot(SMALL_RECT& area) {
+    Control* node = this;
+    for (;;) {
+        if (node->hidden) return nullptr;
+        area = Render::intersect(area, node->rect);
+        if (area.Right < area.Left || area.Bottom < area.Top) return nullptr;
+        if (!node->parent) return node;
+        node = node->parent;
+    }
+}
+
 bool Control::isHovered(const COORD& pos) {
-    return pos.X >= rect.Left && pos.X <= rect.Right && pos.Y >= rect.Top && pos.Y <= rect.Bottom;
+    if (pos.X < rect.Left || pos.X > rect.Right || pos.Y < rect.Top || pos.Y > rect.Bottom) return false;
+    for (Control* node = this; node; node = node->parent) {
+        if (node->hidden) return false;
+        if (node == this) continue;
+        const SMALL_RECT area = node->clientArea();
+        if (pos.X < area.Left || pos.X > area.Right || pos.Y < area.Top || pos.Y > area.Bottom) return false;
+    }
+    return true;
 }
 
 #ifndef DEMO
@@ -12,13 +86,13 @@ void Control::onMouse(const MOUSE_EVENT_RECORD& mer) {
     if (hidden) return;
     bool wasHovered = hovered;
     hovered = isHovered(mer.dwMousePosition);
-    if (hovered != wasHovered) draw();
+    if (hovered != wasHovered) invalidate();
 }
 #else
 void Control::onMouse(const MOUSE_EVENT_RECORD& mer) {
     if (isHovered(mer.dwMousePosition) == hovered) return;
     hovered = !hovered;
-    if (!hidden) draw();
+    if (!hidden) invalidate();
 }
 #endif
 
@@ -26,5 +100,5 @@ void Control::onMouse(const MOUSE_EVENT_RECORD& mer) {
 void Control::setFocus(bool f) {
     if (focused == f) return;
     focused = f;
-    draw();
+    invalidate();
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 // Control.h
 #pragma once
-#include <windows.h>
+#include "Platform.h"
 #include <string>
+#include "LatencyTracker.h"
 
 // Forward declaration
 class FocusManager;
@@ -13,15 +14,61 @@ public:
     SMALL_RECT rect;
     bool focused = false;
     bool hidden = false;
+    bool invalid = false;   // Ждёт перерисовки в FrameScheduler
+    int routeSlot = -1;     // Место в MouseRouter; -1 - мышь не получает
+    InputStamp input;    // Самая ранняя запись ввода, ждущая перерисовки элемента
+    SMALL_RECT damage {};   // Что перерисовать (пока invalid), в координатах экрана
+    Control* parent {nullptr};  // Контейнер, в котором лежит элемент (Container::addControl)
+    int childIndex = -1;        // Место в parent->controls
+    COORD desired {0, 0};       // Размер, который элемент просит у контейнера (кэш measure())
+    bool measureDirty = true;   // desired устарел: элемент ещё не измерен или сменил размер
+    bool layoutDirty = false;   // В поддереве ждёт раскладка (путь от изменённого элемента к корню)
     Control(SMALL_RECT r);
+    virtual ~Control();
 
     virtual void draw() = 0;
+    // Перерисовка области clip (Render::Clip уже установлен): элемент и те его потомки, что её задевают.
+    // Листу хватает draw(); контейнер рисует свой фон и спускается только в пересекающих clip детей.
+    virtual void paint(const SMALL_RECT& clip);
     virtual void onMouse(const MOUSE_EVENT_RECORD& mer);
     virtual void onKey(const KEY_EVENT_RECORD& ker) {(void)ker;};
     virtual void action() {}
     virtual void focusChanged() {}
     virtual void setFocus(bool f);
 
+    // Перерисовать в ближайшем кадре (FrameScheduler), а не сразу
+    void invalidate();
+    // Перерисовать только area: повреждение поднимается к корню дерева, и кадр рисует
+    // от корня лишь поддеревья, которые задевают эту область
+    void invalidate(const SMALL_RECT& area);
+
+    // Корень дерева; area обрезается по rect элемента и всех предков.
+    // nullptr - область не видна (пуста или кто-то на пути скрыт)
+    Control* visibleRoot(SMALL_RECT& area);
+    // Область, в которой видны дети: rect, у ScrollContainer - окно прокрутки
+    virtual SMALL_RECT clientArea() const { return rect; }
+
+    // Сменить rect через arrange(); сменился размер - requestLayout()
+    void setRect(const SMALL_RECT& r);
+
+    // Раскладка в два прохода: контейнер спрашивает у ребёнка желаемый размер (measure),
+    // кэширует его в desired и ставит ребёнка на место (arrange).
+    // По умолчанию элемент хочет размер своего rect.
+    virtual COORD measure();
+    // Поставить элемент в r; контейнер заодно раскладывает своих детей
+    virtual void arrange(const SMALL_RECT& r);
+    // Разложить грязное поддерево (layoutDirty)
+    virtual void layout() { layoutDirty = false; }
+    // Ребёнок сменил желаемый размер или в его поддереве ждёт раскладка
+    virtual void childLayoutChanged(Control& child) { (void)child; }
+
+    // Желаемый размер изменился: помечает путь до корня, корень раскладывается в начале
+    // следующего кадра (FrameScheduler) - только грязные поддеревья
+    void requestLayout();
+    // Раскладка самого элемента устарела (контейнер сменил детей); путь до корня - как выше
+    void markLayoutDirty();
+
+    // pos в rect и не отрезана clientArea() предков (окном ScrollContainer); скрытый элемент - false
     bool isHovered(const COORD& pos);
     bool hasFocus() const { return focused; }
 };
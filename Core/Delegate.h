@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+// Вызываемый объект с буфером на месте: замыкание до Capacity байт хранится внутри Delegate
+// без выделения памяти (лямбда с [this] или парой ссылок, указатель на функцию, std::function),
+// большее - в куче. В отличие от std::function размер буфера задан явно, и
+// malloc при подписке обработчика не нужен.
+template <typename Signature, size_t Capacity = 4 * sizeof(void*)>
+class Delegate;
+
+template <typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+public:
+    Delegate() = default;
+
+    template <typename F, typename Fn = std::decay_t<F>>
+        requires (!std::is_same_v<Fn, Delegate> && std::is_copy_constructible_v<Fn> && std::is_invocable_r_v<R, Fn&, Args...>)
+    Delegate(F&& f) {
+        if constexpr ((std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>) && !std::is_function_v<std::remove_reference_t<F>>) {
+            if (!f) return;  // Пустой указатель - пустой делегат, как у std::function
+        }
+        if constexpr (fitsInline<Fn>) ::new (static_cast<void*>(buffer)) Fn(std::forward<F>(f));
+        else ::new (static_cast<void*>(buffer)) Fn*(new Fn(std::forward<F>(f)));
+        ops = &Model<Fn>::table;
+    }
+
+    Delegate(const Delegate& other) : ops(other.ops) {
+        if (!ops) return;
+        if (ops->trivial) std::memcpy(buffer, other.buffer, Capacity);
+        else ops->copy(buffer, other.buffer);
+    }
+
+    Delegate(Delegate&& other) noexcept : ops(other.ops) {
+        if (!ops) return;
+        if (ops->trivial) std::memcpy(buffer, other.buffer, Capacity);
+        else ops->move(buffer, other.buffer);
+        other.ops = nullptr;
+    }
+
+    Delegate& operator=(const Delegate& other) {
+        if (this != &other) *this = Delegate(other);
+        return *this;
+    }
+
+    Delegate& operator=(Delegate&& other) noexcept {
+        if (this == &other) return *this;
+        reset();
+        ops = other.ops;
+        if (!ops) return *this;
+        if (ops->trivial) std::memcpy(buffer, other.buffer, Capacity);
+        else ops->move(buffer, other.buffer);
+        other.ops = nullptr;
+        return *this;
+    }
+
+    ~Delegate() { reset(); }
+
+    void reset() {
+        if (ops && !ops->trivial) ops->destroy(buffer);
+        ops = nullptr;
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    // Замыкание лежит в буфере, а не в куче
+    bool isInline() const { return ops && ops->inlined; }
+
+    // Как std::function: const-вызов может менять состояние mutable-лямбды
+    R operator()(Args... args) const {
+        return ops->invoke(const_cast<unsigned char*>(buffer), std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    static constexpr bool fitsInline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t)
+                                       && std::is_nothrow_move_constructible_v<F>;
+
+private:
+    struct Ops {
+        R (*invoke)(void*, Args&&...);
+        void (*copy)(void* dst, const void* src);
+        void (*move)(void* dst, void* src);  // src после move уничтожен
+        void (*destroy)(void*);
+        bool inlined;
+        bool trivial;   // Лямбда из указателей и ссылок, указатель на функцию: копия - memcpy буфера
+    };
+
+    template <typename F>
+    struct Model {
+        static F& get(void* p) {
+            if constexpr (fitsInline<F>) return *std::launder(static_cast<F*>(p));
+            else return **std::launder(static_cast<F**>(p));
+        }
+        static R invoke(void* p, Args&&... args) {
+            return std::invoke(get(p), std::forward<Args>(args)...);
+        }
+        static void copy(void* dst, const void* src) {
+            const F& from = get(const_cast<void*>(src));
+            if constexpr (fitsInline<F>) ::new (dst) F(from);
+            else ::new (dst) F*(new F(from));
+        }
+        static void move(void* dst, void* src) {
+            if constexpr (fitsInline<F>) {
+                ::new (dst) F(std::move(get(src)));
+                get(src).~F();
+            } else {
+                ::new (dst) F*(*std::launder(static_cast<F**>(src)));
+            }
+        }
+        static void destroy(void* p) {
+            if constexpr (fitsInline<F>) get(p).~F();
+            else delete &get(p);
+        }
+        static constexpr Ops table { invoke, copy, move, destroy, fitsInline<F>,
+                                     fitsInline<F> && std::is_trivially_copyable_v<F> };
+    };
+
+    // Сам объект или, если не влез, указатель на него в куче
+    alignas(std::max_align_t) unsigned char buffer[Capacity];
+    const Ops* ops {nullptr};
+};
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <functional>
 #include "Control.h"
+#include "Render.h"
 
 class Control;
 class FocusManager {
@@ -49,8 +50,21 @@ public:
         controls[focusedIndex]->setFocus(true);
     }
 
+    // Полная перерисовка: каждое дерево, где есть зарегистрированный элемент, - один раз от корня
     static void redrawAll() {
-        for (auto& ctrl : controls) ctrl->draw();
+        std::vector<Control*> roots;
+        for (auto& ctrl : controls) {
+            Control* root = ctrl.get();
+            while (root->parent) root = root->parent;
+            if (std::find(roots.begin(), roots.end(), root) == roots.end()) roots.push_back(root);
+        }
+        Render::Frame frame;
+        for (Control* root : roots) root->draw();
+    }
+
+    // Элемент в фокусе или nullptr (без исключения, в отличие от getFocused)
+    static Control* focusedControl() {
+        return focusedIndex == -1 ? nullptr : controls[focusedIndex].get();
     }
 
     static std::shared_ptr<Control> getFocused() {
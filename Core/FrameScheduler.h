@@ -0,0 +1,241 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <typeinfo>
+#include "Control.h"
+#include "Render.h"
+
+struct FrameStats {
+    size_t invalidations {0};   // Вызовы invalidate()
+    size_t merged {0};          // Повторные invalidate() элемента, уже ждущего кадра
+    size_t frames {0};          // Нарисованные кадры
+    size_t draws {0};           // Перерисованные по invalidate() элементы
+    size_t regions {0};         // Повреждённые области, перерисованные от корня
+    size_t visits {0};          // Элементы, чей paint() вызван при перерисовке областей
+    size_t idleTicks {0};       // Такты Paced без недействительных элементов
+};
+
+// Планировщик кадров.
+// Элементы не рисуют себя из обработчиков ввода, а вызывают invalidate(); планировщик
+// запоминает каждый элемент один раз (повторные области копятся в его damage) и перерисовывает
+// все недействительные за один кадр. Повреждение поднимается по parent к корню дерева, обрезаясь
+// по rect предков; кадр рисует от корня под Render::Clip только поддеревья, задевающие область,
+// так что смена одной подписи в глубокой раскладке стоит столько, сколько сама подпись:
+// - Immediate - invalidate() сразу вызывает draw() (поведение без планировщика);
+// - Drain     - кадр рисуется, когда EventManager разобрал очередь ввода до конца;
+// - Paced     - кадр рисуется отдельным потоком с частотой hz (start()/stop()).
+// Поток ввода и поток кадров работают с элементами под общим uiMutex().
+// Каждый элемент несёт отметку самой ранней записи ввода, из-за которой он перерисовывается
+// (LatencyTracker) - по ней после вывода кадра считается задержка ввод -> экран.
+class FrameScheduler {
+public:
+    enum Mode { Immediate, Drain, Paced };
+
+    static inline Mode mode {Drain};
+    static inline FrameStats stats;
+
+    static std::recursive_mutex& uiMutex() {
+        static std::recursive_mutex m;
+        return m;
+    }
+
+    static void invalidate(Control* ctrl, const SMALL_RECT& area) {
+        State& s = state();
+        if (mode == Immediate) {
+            stats.invalidations++;
+            SMALL_RECT visible = area;
+            Control* root = ctrl->visibleRoot(visible);
+            if (!root) return;
+            repaint(root, visible);
+            stats.draws++;
+            LatencyTracker::drawn(typeid(*ctrl), LatencyTracker::currentInput());
+            return;
+        }
+        std::lock_guard<std::mutex> lock(s.pendingMutex);
+        stats.invalidations++;
+        LatencyTracker::mark(ctrl->input);
+        if (ctrl->invalid) {
+            stats.merged++;
+            ctrl->damage = unite(ctrl->damage, area);
+            return;
+        }
+        ctrl->invalid = true;
+        ctrl->damage = area;
+        s.pending.push_back(ctrl);
+    }
+
+    // Корень дерева ждёт раскладки (Control::requestLayout): она идёт в начале кадра, до рисования
+    static void scheduleLayout(Control* root) {
+        State& s = state();
+        if (mode == Immediate) {
+            root->layout();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(s.pendingMutex);
+        s.layoutRoots.push_back(root);
+    }
+
+    // Элемент уничтожается - убрать из очереди
+    static void cancel(Control* ctrl) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.pendingMutex);
+        s.layoutRoots.erase(std::remove(s.layoutRoots.begin(), s.layoutRoots.end(), ctrl), s.layoutRoots.end());
+        if (!ctrl->invalid) return;
+        s.pending.erase(std::remove(s.pending.begin(), s.pending.end(), ctrl), s.pending.end());
+        ctrl->invalid = false;
+        ctrl->input = {};
+    }
+
+    // Нарисованное в area сдвинуто на dy строк (Render::scrollArea): повреждение, ждущее кадра, уехало
+    // вместе с содержимым, и перерисовать надо и прежнее место, и новое
+    static void shiftDamage(const SMALL_RECT& area, SHORT dy) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.pendingMutex);
+        for (Control* ctrl : s.pending) {
+            if (!Render::intersects(ctrl->damage, area)) continue;
+            SMALL_RECT moved = Render::intersect(ctrl->damage, area);
+            moved.Top = (std::max)(static_cast<SHORT>(moved.Top + dy), area.Top);
+            moved.Bottom = (std::min)(static_cast<SHORT>(moved.Bottom + dy), area.Bottom);
+            if (moved.Top <= moved.Bottom) ctrl->damage = unite(ctrl->damage, moved);
+        }
+    }
+
+    static bool hasPending() {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.pendingMutex);
+        return !s.pending.empty() || !s.layoutRoots.empty();
+    }
+
+    // Рисует все недействительные элементы одним кадром. Вызывается под uiMutex().
+    static void drain() {
+        State& s = state();
+        layout();
+        {
+            std::lock_guard<std::mutex> lock(s.pendingMutex);
+            if (s.pending.empty()) return;
+            s.drawing.swap(s.pending);
+            for (Control* ctrl : s.drawing) {
+                ctrl->invalid = false;
+                s.drawingInput.push_back(ctrl->input);
+                ctrl->input = {};
+            }
+        }
+        // Области - от корней; пересекающиеся области одного корня рисуются одной
+        for (size_t i = 0; i < s.drawing.size(); ++i) {
+            Control* ctrl = s.drawing[i];
+            SMALL_RECT area = ctrl->damage;
+            Control* root = ctrl->visibleRoot(area);
+            if (!root) continue;
+            addRegion(root, area);
+            stats.draws++;
+            LatencyTracker::drawn(typeid(*ctrl), s.drawingInput[i]);
+        }
+        Render::Frame frame;
+        for (const Region& region : s.regions) repaint(region.root, region.area);
+        s.regions.clear();
+        s.drawing.clear();
+        s.drawingInput.clear();
+        stats.frames++;
+    }
+
+    // Раскладка деревьев, которые её ждут (drain() начинает с неё); сдвинутое попадает в pending.
+    // Вызывается под uiMutex().
+    static void layout() {
+        State& s = state();
+        {
+            std::lock_guard<std::mutex> lock(s.pendingMutex);
+            if (s.layoutRoots.empty()) return;
+            s.laying.swap(s.layoutRoots);
+        }
+        for (Control* root : s.laying) root->layout();
+        s.laying.clear();
+    }
+
+    // Область area дерева root: всё, что её задевает, рисуется заново (под uiMutex())
+    static void repaint(Control* root, const SMALL_RECT& area) {
+        stats.regions++;
+        Render::Clip clip(area);
+        root->paint(area);
+    }
+
+    // Режим Paced: поток тактов с частотой hz
+    static void start(int hz = 60) {
+        stop();
+        mode = Paced;
+        running = true;
+        ticker.thread = std::thread([hz]() {
+            const auto period = std::chrono::nanoseconds(1'000'000'000 / (std::max)(hz, 1));
+            auto next = std::chrono::steady_clock::now() + period;
+            while (running) {
+                std::this_thread::sleep_until(next);
+                next += period;
+                std::lock_guard<std::recursive_mutex> lock(uiMutex());
+                if (hasPending()) drain();
+                else stats.idleTicks++;
+            }
+        });
+    }
+
+    static void stop() {
+        running = false;
+        if (ticker.thread.joinable()) ticker.thread.join();
+        if (mode == Paced) mode = Drain;
+    }
+
+    static void resetStats() { stats = {}; }
+
+    static SMALL_RECT unite(const SMALL_RECT& a, const SMALL_RECT& b) {
+        return { (std::min)(a.Left, b.Left), (std::min)(a.Top, b.Top), (std::max)(a.Right, b.Right), (std::max)(a.Bottom, b.Bottom) };
+    }
+
+private:
+    struct Region {
+        Control* root;
+        SMALL_RECT area;
+    };
+
+    // Состояние не разрушается при выходе из программы: элементы из статических контейнеров
+    // (FocusManager) разрушаются позже него и в ~Control убираются из очередей (cancel)
+    struct State {
+        std::mutex pendingMutex;
+        std::vector<Control*> pending;
+        std::vector<Control*> drawing;          // Кадр, который рисуется сейчас
+        std::vector<InputStamp> drawingInput;   // Отметки ввода элементов drawing
+        std::vector<Region> regions;            // Области кадра, который рисуется сейчас
+        std::vector<Control*> layoutRoots;      // Корни, ждущие раскладки
+        std::vector<Control*> laying;           // Раскладываются сейчас
+    };
+
+    static State& state() {
+        static State* s = new State;
+        return *s;
+    }
+
+    static inline std::atomic<bool> running {false};
+
+    // Поток тактов останавливается и при выходе из программы без stop()
+    struct Ticker {
+        std::thread thread;
+        ~Ticker() {
+            running = false;
+            if (thread.joinable()) thread.join();
+        }
+    };
+    static inline Ticker ticker;
+
+    // Область, задевающая уже собранную область того же корня, сливается с ней
+    static void addRegion(Control* root, SMALL_RECT area) {
+        State& s = state();
+        for (size_t i = 0; i < s.regions.size(); ++i) {
+            if (s.regions[i].root != root || !Render::intersects(s.regions[i].area, area)) continue;
+            area = unite(s.regions[i].area, area);
+            s.regions.erase(s.regions.begin() + i);
+            i = static_cast<size_t>(-1);    // Объединённая область могла задеть и другие
+        }
+        s.regions.push_back({ root, area });
+    }
+};
@@ -1,61 +1,399 @@
 #pragma once
-#include <thread>
 #include <atomic>
 #include <vector>
-#include <functional>
-#include <Windows.h>
-#include <shared_mutex>
+#include <memory>
 #include <mutex>
-#include <algorithm>
+#include <shared_mutex>
+#include <cstdint>
+#include <type_traits>
+#include "Platform.h"
+#include "Delegate.h"
+
+// Идентификатор подписки: номер слота и поколение. Слот после удаления переиспользуется
+// со следующим поколением, так что старый идентификатор ничего не удалит.
+template <typename T>
+struct HandlerId {
+    uint32_t slot {UINT32_MAX};
+    uint32_t generation {0};
 
-template<typename T>
-using HandlerPtr = std::shared_ptr<std::function<void(const T&)>>; // Это нужно не для контроля памяти, а для сравнения через ==.
+    explicit operator bool() const { return slot != UINT32_MAX; }
+    bool operator==(const HandlerId&) const = default;
+};
 
-// Шаблонный класс для хранения обработчиков и их мьютекса
 template <typename T>
+using Handler = Delegate<void(const T&)>;
+
+// Стратегии блокировки HandlerContainer; выбираются при компиляции.
+// Во всех стратегиях обработчик может подписывать и отписывать обработчики своего же списка:
+// изменения вступают в силу со следующего события.
+struct NullMutex {
+    void lock() {}
+    void unlock() {}
+    void lock_shared() {}
+    void unlock_shared() {}
+};
+
+// Без блокировок: подписка и раздача только из одного потока
+struct SingleThreaded {
+    using Mutex = NullMutex;
+    using DeferMutex = NullMutex;
+    static constexpr bool sharedDispatch = false;
+};
+
+// Один мьютекс на всё: раздача держит его, подписка из другого потока ждёт конца раздачи
+struct Locked {
+    using Mutex = std::recursive_mutex;
+    using DeferMutex = NullMutex;
+    static constexpr bool sharedDispatch = false;
+};
+
+// shared_mutex: несколько потоков раздают одновременно, подписка ждёт, пока раздачи закончатся
+struct SharedLocked {
+    using Mutex = std::shared_mutex;
+    using DeferMutex = std::mutex;
+    static constexpr bool sharedDispatch = true;
+};
+
+// Неизменяемый снимок (RCU): раздача без блокировок, подписка под мьютексом писателей
+struct LockFree {};
+
+// Плотный массив делегатов в порядке подписки + таблица слотов с поколениями.
+// Stored - как хранится делегат (LockFree хранит shared_ptr, на который ссылаются снимки).
+// Сам не синхронизирован - это делает HandlerContainer.
+// insert дописывает в конец, remove по слоту находит запись и гасит её - оба O(1),
+// без выделения памяти на подписку. Погашенные записи вычищаются, когда их становится
+// больше половины (порядок сохраняется).
+template <typename T, typename Stored = Handler<T>>
+class HandlerStore {
+public:
+    struct Entry {
+        Stored handler;             // Пустой - запись удалена
+        uint32_t slot;
+    };
+
+    // Слот под будущую запись: идентификатор известен сразу, запись появится в insert
+    HandlerId<T> reserve() {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        slots[slot].index = reserved;
+        return { slot, slots[slot].generation };
+    }
+
+    void insert(HandlerId<T> id, Stored handler) {
+        slots[id.slot].index = static_cast<uint32_t>(entries.size());
+        entries.push_back({ std::move(handler), id.slot });
+    }
+
+    // Устаревший или чужой идентификатор - false
+    bool remove(HandlerId<T> id) {
+        if (id.slot >= slots.size()) return false;
+        Slot& slot = slots[id.slot];
+        if (slot.index >= entries.size() || slot.generation != id.generation) return false;
+        entries[slot.index].handler.reset();
+        release(id.slot);
+        if (++removed > entries.size() / 2) compact();
+        return true;
+    }
+
+    // Выданные идентификаторы становятся недействительными
+    void clear() {
+        for (const Entry& entry : entries) {
+            if (entry.handler) release(entry.slot);
+        }
+        entries.clear();
+        removed = 0;
+    }
+
+    size_t size() const { return entries.size() - removed; }
+
+    // Все записи, включая погашенные (пустой handler)
+    const std::vector<Entry>& items() const { return entries; }
+
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+    static constexpr uint32_t reserved = UINT32_MAX - 1;
+
+    struct Slot {
+        uint32_t generation {1};
+        uint32_t index {npos};      // Позиция в entries; npos - слот свободен
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<Entry> entries;
+    size_t removed {0};
+
+    void release(uint32_t slot) {
+        slots[slot].index = npos;
+        slots[slot].generation++;
+        freeSlots.push_back(slot);
+    }
+
+    void compact() {
+        size_t out = 0;
+        for (Entry& entry : entries) {
+            if (!entry.handler) continue;
+            slots[entry.slot].index = static_cast<uint32_t>(out);
+            if (&entries[out] != &entry) entries[out] = std::move(entry);
+            ++out;
+        }
+        entries.resize(out);
+        removed = 0;
+    }
+};
+
+// Раздачи, идущие сейчас в этом потоке (цепочка по стеку): подписка изнутри обработчика
+// не может ждать блокировку, которую держит та же раздача, и откладывается
+struct DispatchScope {
+    const void* container;
+    DispatchScope* outer;
+
+    static inline thread_local DispatchScope* top = nullptr;
+
+    explicit DispatchScope(const void* c) : container(c), outer(top) { top = this; }
+    ~DispatchScope() { top = outer; }
+    DispatchScope(const DispatchScope&) = delete;
+    DispatchScope& operator=(const DispatchScope&) = delete;
+
+    static bool inside(const void* c) {
+        for (DispatchScope* scope = top; scope; scope = scope->outer) {
+            if (scope->container == c) return true;
+        }
+        return false;
+    }
+};
+
+// Обработчики одного типа события со стратегией блокировки Locking.
+// SingleThreaded / Locked / SharedLocked: раздача идёт прямо по массиву под блокировкой стратегии.
+// Подписка и отписка из обработчика этого же списка копятся в очереди и применяются,
+// когда самая внешняя раздача закончится.
+template <typename T, typename Locking = LockFree>
 class HandlerContainer {
+public:
+    HandlerId<T> addHandler(Handler<T> handler) {
+        if (DispatchScope::inside(this)) {
+            std::lock_guard defer(deferMutex);
+            HandlerId<T> id = store.reserve();
+            deferred.push_back({ Deferred::Add, id, std::move(handler) });
+            hasDeferred = true;
+            return id;
+        }
+        std::unique_lock lock(mutex);
+        std::lock_guard defer(deferMutex);
+        flush();
+        HandlerId<T> id = store.reserve();
+        store.insert(id, std::move(handler));
+        return id;
+    }
+
+    bool removeHandler(HandlerId<T> id) {
+        if (DispatchScope::inside(this)) {
+            std::lock_guard defer(deferMutex);
+            deferred.push_back({ Deferred::Remove, id, {} });
+            hasDeferred = true;
+            return true;    // Отписка поставлена в очередь
+        }
+        std::unique_lock lock(mutex);
+        std::lock_guard defer(deferMutex);
+        flush();
+        return store.remove(id);
+    }
+
+    void clearHandlers() {
+        if (DispatchScope::inside(this)) {
+            std::lock_guard defer(deferMutex);
+            deferred.push_back({ Deferred::Clear, {}, {} });
+            hasDeferred = true;
+            return;
+        }
+        std::unique_lock lock(mutex);
+        std::lock_guard defer(deferMutex);
+        flush();
+        store.clear();
+    }
+
+    size_t size() {
+        std::unique_lock lock(mutex);
+        std::lock_guard defer(deferMutex);
+        flush();
+        return store.size();
+    }
+
+    void invokeHandlers(const T& event) {
+        bool nested = DispatchScope::inside(this);  // Блокировку уже держит внешняя раздача
+        {
+            DispatchScope scope(this);
+            if constexpr (Locking::sharedDispatch) {
+                std::shared_lock lock(mutex, std::defer_lock);
+                if (!nested) lock.lock();
+                invokeAll(event);
+            } else {
+                std::unique_lock lock(mutex, std::defer_lock);
+                if (!nested) lock.lock();
+                invokeAll(event);
+                if (!nested && hasDeferred) {
+                    std::lock_guard defer(deferMutex);
+                    flush();
+                }
+            }
+        }
+        // shared_lock отпущен - отложенные изменения применяются под исключительной блокировкой
+        if constexpr (Locking::sharedDispatch) {
+            if (!nested && hasDeferred) {
+                std::unique_lock lock(mutex);
+                std::lock_guard defer(deferMutex);
+                flush();
+            }
+        }
+    }
+
 private:
-    std::vector<HandlerPtr<T>> handlers;
-    mutable std::mutex mutex;
+    struct Deferred {
+        enum Op : uint8_t { Add, Remove, Clear } op;
+        HandlerId<T> id;
+        Handler<T> handler;
+    };
+
+    HandlerStore<T> store;
+    std::vector<Deferred> deferred;
+    std::atomic<bool> hasDeferred {false};
+    typename Locking::Mutex mutex;
+    typename Locking::DeferMutex deferMutex;    // Очередь и слоты, когда подписывают несколько раздач сразу
+
+    void invokeAll(const T& event) {
+        for (const auto& entry : store.items()) {
+            if (entry.handler) entry.handler(event);
+        }
+    }
 
+    // Под исключительной блокировкой и deferMutex
+    void flush() {
+        if (!hasDeferred) return;
+        for (Deferred& change : deferred) {
+            switch (change.op) {
+                case Deferred::Add: store.insert(change.id, std::move(change.handler)); break;
+                case Deferred::Remove: store.remove(change.id); break;
+                case Deferred::Clear: store.clear(); break;
+            }
+        }
+        deferred.clear();
+        hasDeferred = false;
+    }
+};
+
+// LockFree: раздача по неизменяемому снимку живых делегатов (RCU). invokeHandlers читает его
+// одним атомарным load, без мьютекса; после подписок снимок пересобирается один раз - первым
+// следующим событием, а не на каждое изменение.
+// Снимок ссылается на делегаты списка, а не копирует их: состояние mutable-лямбды переживает
+// пересборку, а захваченное обработчиком отпускается, как только его не держит ни список, ни раздача.
+template <typename T>
+class HandlerContainer<T, LockFree> {
 public:
-    // Добавление обработчика
-    HandlerPtr<T> addHandler(std::function<void(const T&)> handler) {
-        std::lock_guard lock(mutex); 
-        auto handlerPtr = std::make_shared<std::function<void(const T&)>>(handler);
-        handlers.push_back(handlerPtr);
-        return handlerPtr; 
+    using Shared = std::shared_ptr<const Handler<T>>;
+    using List = std::vector<Shared>;
+
+    HandlerId<T> addHandler(Handler<T> handler) {
+        std::lock_guard lock(mutex);
+        HandlerId<T> id = store.reserve();
+        store.insert(id, std::make_shared<const Handler<T>>(std::move(handler)));
+        changed();
+        return id;
+    }
+
+    bool removeHandler(HandlerId<T> id) {
+        std::lock_guard lock(mutex);
+        if (!store.remove(id)) return false;
+        changed();
+        trimSpare();
+        return true;
     }
 
     void clearHandlers() {
         std::lock_guard lock(mutex);
-        handlers.clear();
+        store.clear();
+        changed();
+        trimSpare();
     }
 
-    // Удаление обработчика по указателю
-    bool removeHandler(const HandlerPtr<T>& handlerPtr) {
-        std::lock_guard lock(mutex); 
-        auto it = std::find_if(handlers.begin(), handlers.end(), [&handlerPtr](const auto& ptr) {
-            return ptr == handlerPtr; 
-        });
-        if (it != handlers.end()) {
-            handlers.erase(it); 
-            return true; 
-        }
-        return false; 
+    size_t size() const {
+        std::lock_guard lock(mutex);
+        return store.size();
     }
 
-    // Вызов всех обработчиков
+    // Текущий снимок (для отладки и бенчмарков)
+    std::shared_ptr<const List> snapshot() const {
+        auto current = acquire();
+        return std::shared_ptr<const List>(current, &current->handlers);
+    }
+
+    // Вызов всех обработчиков по снимку: обработчик может добавлять/удалять обработчики,
+    // изменения увидит следующее событие
     void invokeHandlers(const T& event) const {
-        std::vector<HandlerPtr<T>> handlersCopy;
-        {
-            std::lock_guard lock(mutex);
-            handlersCopy = handlers; 
+        auto current = acquire();
+        for (const Shared& handler : current->handlers) {
+            (*handler)(event);
         }
+    }
 
-        for (const auto& handler : handlersCopy) {
-            (*handler)(event); 
-        }
+private:
+    struct Snapshot {
+        uint64_t version;
+        List handlers;
+    };
+
+    HandlerStore<T, Shared> store;
+    std::atomic<uint64_t> version {0};      // Растёт с каждым изменением списка
+
+    mutable std::atomic<std::shared_ptr<const Snapshot>> snapshotPtr {std::make_shared<Snapshot>()};
+    mutable std::shared_ptr<Snapshot> spare;   // Снятый с публикации снимок - под следующую сборку (пустой)
+    mutable std::mutex mutex;  // Писатели и пересборка снимка; раздача по готовому снимку его не берёт
+
+    void changed() { version.fetch_add(1, std::memory_order_release); }
+
+    // Под mutex. Снятый снимок, который больше никто не читает, отпускает делегаты сразу, а не
+    // при следующей сборке; буфер остаётся под неё
+    void trimSpare() const {
+        if (!spare || spare.use_count() != 1 || spare->handlers.empty()) return;
+        std::atomic_thread_fence(std::memory_order_acquire);  // Читатели, отпустившие снимок, закончили с ним
+        spare->handlers.clear();
     }
 
-};
\ No newline at end of file
+    std::shared_ptr<const Snapshot> acquire() const {
+        auto current = snapshotPtr.load(std::memory_order_acquire);
+        if (current->version == version.load(std::memory_order_acquire)) return current;
+        current.reset();    // Устаревший снимок не держим: rebuild() отпустит его делегаты
+        return rebuild();
+    }
+
+    // Снимок отстал от списка - собрать новый. Прошлый снимок, когда его уже никто не читает,
+    // идёт под следующую сборку, так что сама пересборка в установившемся режиме память не выделяет
+    std::shared_ptr<const Snapshot> rebuild() const {
+        std::lock_guard lock(mutex);
+        auto current = snapshotPtr.load(std::memory_order_acquire);
+        uint64_t v = version.load(std::memory_order_relaxed);
+        if (current->version == v) return current;
+        std::shared_ptr<Snapshot> next;
+        if (spare && spare.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);  // Читатели, отпустившие снимок, закончили с ним
+            next = std::move(spare);
+            next->handlers.clear();
+        } else {
+            next = std::make_shared<Snapshot>();
+        }
+        next->version = v;
+        next->handlers.reserve(store.size());
+        for (const auto& entry : store.items()) {
+            if (entry.handler) next->handlers.push_back(entry.handler);
+        }
+        snapshotPtr.store(next, std::memory_order_release);
+        spare = std::const_pointer_cast<Snapshot>(std::move(current));
+        trimSpare();
+        return next;
+    }
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "RenderBackend.h"
+
+// Экран в памяти без какого-либо ввода-вывода.
+// Нужен, чтобы мерить стоимость самих виджетов отдельно от терминала и проверять результат отрисовки.
+class HeadlessBackend : public RenderBackend {
+public:
+    struct Stats {
+        size_t runs {0};    // Вызовы writeRun / fillRun / writeColumn
+        size_t cells {0};   // Записанные ячейки
+        size_t clears {0};
+        size_t scrolls {0}; // Сдвиги scrollRect
+        size_t flushes {0};
+    };
+    Stats stats;
+
+private:
+    COORD screenSize;
+    std::vector<Cell> cells;
+
+public:
+    explicit HeadlessBackend(COORD s = { 120, 40 }) : screenSize(s), cells(static_cast<size_t>(s.X) * s.Y) {}
+
+    COORD size() override { return screenSize; }
+
+    void writeRun(COORD pos, const Cell* src, SHORT length) override {
+        stats.runs++;
+        if (pos.Y < 0 || pos.Y >= screenSize.Y) return;
+        SHORT from = std::max<SHORT>(pos.X, 0);
+        SHORT to = std::min<SHORT>(pos.X + length, screenSize.X);
+        if (to <= from) return;
+        std::copy(src + (from - pos.X), src + (to - pos.X), &at(from, pos.Y));
+        stats.cells += to - from;
+    }
+
+    void fillRun(COORD pos, const Cell& cell, SHORT length) override {
+        stats.runs++;
+        if (pos.Y < 0 || pos.Y >= screenSize.Y) return;
+        SHORT from = std::max<SHORT>(pos.X, 0);
+        SHORT to = std::min<SHORT>(pos.X + length, screenSize.X);
+        if (to <= from) return;
+        std::fill(&at(from, pos.Y), &at(from, pos.Y) + (to - from), cell);
+        stats.cells += to - from;
+    }
+
+    void writeColumn(COORD pos, const Cell* src, SHORT length) override {
+        stats.runs++;
+        if (pos.X < 0 || pos.X >= screenSize.X) return;
+        for (SHORT i = 0; i < length; ++i) {
+            SHORT y = pos.Y + i;
+            if (y < 0 || y >= screenSize.Y) continue;
+            at(pos.X, y) = src[i];
+            stats.cells++;
+        }
+    }
+
+    bool scrollRect(const SMALL_RECT& area, SHORT dy, const Cell& fill) override {
+        stats.scrolls++;
+        SHORT left = std::max<SHORT>(area.Left, 0), right = std::min<SHORT>(area.Right, screenSize.X - 1);
+        SHORT top = std::max<SHORT>(area.Top, 0), bottom = std::min<SHORT>(area.Bottom, screenSize.Y - 1);
+        if (right < left || bottom < top) return true;
+        const size_t width = static_cast<size_t>(right - left + 1);
+        // Строки копируются со стороны, куда идёт сдвиг, чтобы не затереть ещё не скопированные
+        for (int i = 0; i <= bottom - top; ++i) {
+            SHORT y = static_cast<SHORT>(dy > 0 ? bottom - i : top + i);
+            int from = y - dy;
+            if (from >= top && from <= bottom) std::copy_n(&at(left, static_cast<SHORT>(from)), width, &at(left, y));
+            else std::fill_n(&at(left, y), width, fill);
+        }
+        return true;
+    }
+
+    void clear(WORD attr) override {
+        stats.clears++;
+        std::fill(cells.begin(), cells.end(), Cell{ L' ', attr });
+    }
+
+    void resize(COORD s) override {
+        screenSize = s;
+        cells.assign(static_cast<size_t>(s.X) * s.Y, Cell{});
+    }
+
+    void flush() override { stats.flushes++; }
+
+    void resetStats() { stats = {}; }
+
+    Cell& at(SHORT x, SHORT y) { return cells[static_cast<size_t>(y) * screenSize.X + x]; }
+
+    // Текст строки экрана - удобно для проверок и отладки
+    std::wstring row(SHORT y) const {
+        std::wstring text;
+        for (SHORT x = 0; x < screenSize.X; ++x) {
+            const Cell& cell = cells[static_cast<size_t>(y) * screenSize.X + x];
+            if (!(cell.flags & Cell::WideTrail)) text += cell.ch;
+        }
+        return text;
+    }
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <climits>
+#include "Platform.h"
+
+// Сколько записей поглощено слиянием (за вызов apply или всего)
+struct CoalesceCounts {
+    size_t moves {0};
+    size_t wheels {0};
+    size_t resizes {0};
+
+    size_t total() const { return moves + wheels + resizes; }
+};
+
+// Слияние соседних однотипных записей пачки ввода перед раздачей обработчикам.
+// Быстрое движение мыши даёт десятки MOUSE_MOVED подряд - обработчикам нужна только последняя позиция;
+// прокрутка колеса даёт серию MOUSE_WHEELED - их смещения складываются в одно событие.
+// Сливаются только соседние записи: нажатия кнопок, клавиши и всё остальное остаются на своих местах
+// и разделяют серии, так что порядок ввода не меняется.
+class InputCoalescer {
+public:
+    enum Policy : uint8_t {
+        Keep,       // Не сливать
+        Latest,     // Серия заменяется последней записью
+        Sum         // Колесо: смещения серии складываются (для остальных типов - как Latest)
+    };
+
+    Policy move {Latest};       // MOUSE_MOVED с одинаковыми кнопками и модификаторами
+    Policy wheel {Sum};         // MOUSE_WHEELED
+    Policy hwheel {Sum};        // MOUSE_HWHEELED
+    Policy resize {Latest};     // WINDOW_BUFFER_SIZE_EVENT
+
+    // Сжимает records на месте, возвращает новое число записей.
+    // stamps (если есть) - параллельный массив моментов чтения; слитая запись сохраняет
+    // момент первой записи серии, чтобы задержка считалась от самого раннего ввода.
+    size_t apply(INPUT_RECORD* records, size_t count, CoalesceCounts& merged, long long* stamps = nullptr) const {
+        if (count == 0) return 0;
+        size_t out = 0;
+        for (size_t i = 1; i < count; ++i) {
+            if (merge(records[out], records[i], merged)) continue;
+            records[++out] = records[i];
+            if (stamps) stamps[out] = stamps[i];
+        }
+        return out + 1;
+    }
+
+    // Сливает next в last по политике; false - записи остаются раздельными
+    bool merge(INPUT_RECORD& last, const INPUT_RECORD& next, CoalesceCounts& merged) const {
+        if (last.EventType != next.EventType) return false;
+        if (next.EventType == WINDOW_BUFFER_SIZE_EVENT) {
+            if (resize == Keep) return false;
+            last = next;
+            merged.resizes++;
+            return true;
+        }
+        if (next.EventType != MOUSE_EVENT) return false;
+
+        MOUSE_EVENT_RECORD& a = last.Event.MouseEvent;
+        const MOUSE_EVENT_RECORD& b = next.Event.MouseEvent;
+        if (a.dwEventFlags != b.dwEventFlags || a.dwControlKeyState != b.dwControlKeyState) return false;
+        switch (b.dwEventFlags) {
+            case MOUSE_MOVED:
+                // Смена состояния кнопок (начало/конец перетаскивания) - не слияние
+                if (move == Keep || a.dwButtonState != b.dwButtonState) return false;
+                a = b;
+                merged.moves++;
+                return true;
+            case MOUSE_WHEELED:
+            case MOUSE_HWHEELED: {
+                Policy policy = b.dwEventFlags == MOUSE_WHEELED ? wheel : hwheel;
+                if (policy == Keep) return false;
+                int delta = wheelDelta(b);
+                if (policy == Sum) {
+                    delta += wheelDelta(a);
+                    if (delta > SHRT_MAX || delta < SHRT_MIN) return false;  // Не влезет в HIWORD
+                }
+                a = b;
+                a.dwButtonState = (static_cast<DWORD>(static_cast<WORD>(delta)) << 16) | (b.dwButtonState & 0xFFFF);
+                merged.wheels++;
+                return true;
+            }
+            default:
+                return false;   // Нажатия и двойные щелчки не сливаются
+        }
+    }
+
+private:
+    static short wheelDelta(const MOUSE_EVENT_RECORD& mer) { return static_cast<short>(HIWORD(mer.dwButtonState)); }
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "Platform.h"
+#include "InputCoalescer.h"
+
+// Полосы ввода с приоритетами: диспетчер EventManager раскладывает записи по трём полосам и
+// за один кадр разбирает их по порядку приоритета, не больше budget записей из каждой:
+//   Keys   - клавиатура, фокус, меню;
+//   Clicks - нажатия, отпускания, двойные щелчки и колесо мыши;
+//   Motion - движения мыши и смена размера окна.
+// Поток движений над множеством элементов не задерживает нажатия клавиш: они уходят в начало кадра,
+// а то, что не влезло в бюджет Motion, ждёт следующего кадра. Когда хвост Motion длиннее backlog,
+// соседние движения в нём сливаются (merging), так что полоса не растёт без предела.
+// Порядок, от которого зависит смысл ввода, сохраняется - раньше записи выдаются те, от кого она зависит
+// (даже сверх бюджета их полосы):
+//   клавиша - после более ранних щелчков (щелчок мог сменить фокус);
+//   щелчок  - после более ранних движений (наведение до щелчка).
+// prioritize = false - одна полоса, всё подряд в порядке поступления, без бюджета.
+class InputLanes {
+public:
+    enum Lane : uint8_t { Keys, Clicks, Motion, LaneCount };
+
+    bool prioritize {true};
+    std::array<size_t, LaneCount> budget {256, 64, 32};    // Записей полосы за кадр
+    size_t backlog {64};                                    // Длиннее - Motion сливается
+    InputCoalescer merging;                                 // Политика слияния хвоста Motion
+
+    static Lane laneOf(const INPUT_RECORD& record) {
+        if (record.EventType == MOUSE_EVENT) return record.Event.MouseEvent.dwEventFlags == MOUSE_MOVED ? Motion : Clicks;
+        if (record.EventType == WINDOW_BUFFER_SIZE_EVENT) return Motion;
+        return Keys;
+    }
+
+    void push(const INPUT_RECORD& record, long long readNs) {
+        queues[prioritize ? laneOf(record) : Keys].push(record, readNs, nextSeq++);
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t size(Lane lane) const { return queues[lane].size(); }
+    size_t size() const { return queues[Keys].size() + queues[Clicks].size() + queues[Motion].size(); }
+
+    // Один кадр: emit(record, readNs) для каждой выданной записи. Возвращает их число
+    template <typename F>
+    size_t frame(F&& emit, CoalesceCounts& merged) {
+        std::array<size_t, LaneCount> left = budget;
+        size_t emitted = 0;
+        if (!prioritize) {
+            for (Lane lane : { Keys, Clicks, Motion }) {
+                while (!queues[lane].empty()) emitted += emitFront(lane, emit, left);
+            }
+            return emitted;
+        }
+        if (queues[Motion].size() > backlog) coalesceMotion(merged);
+        for (Lane lane : { Keys, Clicks, Motion }) {
+            while (left[lane] > 0 && !queues[lane].empty()) emitted += emitFront(lane, emit, left);
+        }
+        return emitted;
+    }
+
+    void clear() {
+        for (Queue& q : queues) q.clear();
+    }
+
+private:
+    // Полоса - массивы записей, моментов чтения и сквозных номеров; голова сдвигается по head
+    struct Queue {
+        std::vector<INPUT_RECORD> records;
+        std::vector<long long> stamps;
+        std::vector<uint64_t> seqs;
+        size_t head {0};
+
+        void push(const INPUT_RECORD& record, long long stamp, uint64_t seq) {
+            records.push_back(record);
+            stamps.push_back(stamp);
+            seqs.push_back(seq);
+        }
+
+        bool empty() const { return head == records.size(); }
+        size_t size() const { return records.size() - head; }
+
+        void pop() {
+            if (++head < records.size()) return;
+            clear();    // Полоса разобрана - массивы снова с начала, память остаётся
+        }
+
+        void clear() {
+            records.clear();
+            stamps.clear();
+            seqs.clear();
+            head = 0;
+        }
+    };
+
+    std::array<Queue, LaneCount> queues;
+    uint64_t nextSeq {0};
+
+    template <typename F>
+    size_t emitFront(Lane lane, F& emit, std::array<size_t, LaneCount>& left) {
+        Queue& q = queues[lane];
+        uint64_t seq = q.seqs[q.head];
+        size_t emitted = 0;
+        if (prioritize) {
+            if (lane == Keys) emitted += release(Clicks, seq, emit, left);
+            if (lane == Clicks) emitted += release(Motion, seq, emit, left);
+        }
+        INPUT_RECORD record = q.records[q.head];
+        long long stamp = q.stamps[q.head];
+        q.pop();
+        if (left[lane] > 0) --left[lane];
+        emit(record, stamp);
+        return emitted + 1;
+    }
+
+    // Всё, что в полосе lane старше записи с номером before
+    template <typename F>
+    size_t release(Lane lane, uint64_t before, F& emit, std::array<size_t, LaneCount>& left) {
+        size_t emitted = 0;
+        Queue& q = queues[lane];
+        while (!q.empty() && q.seqs[q.head] < before) emitted += emitFront(lane, emit, left);
+        return emitted;
+    }
+
+    // Сливает соседние записи хвоста Motion. Слитая запись берёт номер последней (не обгоняет
+    // щелчки, что были между ними) и момент чтения первой (задержка - от самого раннего ввода)
+    void coalesceMotion(CoalesceCounts& merged) {
+        Queue& q = queues[Motion];
+        size_t out = q.head;
+        for (size_t i = q.head + 1; i < q.records.size(); ++i) {
+            if (merging.merge(q.records[out], q.records[i], merged)) {
+                q.seqs[out] = q.seqs[i];
+                continue;
+            }
+            ++out;
+            q.records[out] = q.records[i];
+            q.stamps[out] = q.stamps[i];
+            q.seqs[out] = q.seqs[i];
+        }
+        q.records.resize(out + 1);
+        q.stamps.resize(out + 1);
+        q.seqs.resize(out + 1);
+    }
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include <algorithm>
+#include "Platform.h"
+
+// Откуда EventManager берёт сырые события ввода.
+// read() блокирует поток чтения до появления событий; false - источник закрыт, ошибка или отмена.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    virtual bool read(INPUT_RECORD* records, DWORD capacity, DWORD& count) = 0;
+
+    // Из другого потока: будит read(), тот возвращает false. Действует до restart()
+    virtual void cancel() {}
+    // Снова разрешает чтение после cancel() (EventManager::start)
+    virtual void restart() {}
+};
+
+// Пауза, которую прерывает cancel() из другого потока (ScriptedInputSource, TraceInputSource)
+class CancellableWait {
+public:
+    // false - ожидание отменено
+    template <typename Clock, typename Duration>
+    bool until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return !signal.wait_until(lock, deadline, [this] { return stopped; });
+    }
+
+    template <typename Rep, typename Period>
+    bool wait(const std::chrono::duration<Rep, Period>& interval) { return until(std::chrono::steady_clock::now() + interval); }
+
+    bool cancelled() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stopped;
+    }
+
+    void cancel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        signal.notify_all();
+    }
+
+    void restart() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = false;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable signal;
+    bool stopped {false};
+};
+
+// Консоль: ReadConsoleInput на STD_INPUT_HANDLE.
+// Поток чтения ждёт сразу консоль и событие отмены, так что cancel() будит его без ввода с клавиатуры.
+class ConsoleInputSource : public InputSource {
+public:
+    ConsoleInputSource() : cancelEvent(CreateEvent(nullptr, TRUE, FALSE, nullptr)) {}
+    ~ConsoleInputSource() override { CloseHandle(cancelEvent); }
+    ConsoleInputSource(const ConsoleInputSource&) = delete;
+    ConsoleInputSource& operator=(const ConsoleInputSource&) = delete;
+
+    bool read(INPUT_RECORD* records, DWORD capacity, DWORD& count) override {
+        HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
+        if (hInput == INVALID_HANDLE_VALUE) return false;
+        // Отмена первой: если готовы оба, побеждает она
+        HANDLE handles[2] = { cancelEvent, hInput };
+        if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) return false;
+        if (!ReadConsoleInput(hInput, records, capacity, &count)) {
+            std::cerr << "Error reading console input" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void cancel() override { SetEvent(cancelEvent); }
+    void restart() override { ResetEvent(cancelEvent); }
+
+private:
+    HANDLE cancelEvent;
+};
+
+// Заранее записанный ввод вместо консоли (Linux, бенчмарки): отдаёт события пачками
+// по batch штук, между пачками выжидает interval - как человек или мышь, которые шлют события
+// с конечной скоростью. Когда сценарий кончился, read() возвращает false.
+class ScriptedInputSource : public InputSource {
+public:
+    std::vector<INPUT_RECORD> script;
+    DWORD batch {16};
+    std::chrono::nanoseconds interval {0};
+
+    ScriptedInputSource() = default;
+    explicit ScriptedInputSource(std::vector<INPUT_RECORD> s, DWORD b = 16, std::chrono::nanoseconds i = std::chrono::nanoseconds(0))
+        : script(std::move(s)), batch(b), interval(i) {}
+
+    bool read(INPUT_RECORD* records, DWORD capacity, DWORD& count) override {
+        if (next >= script.size() || pause.cancelled()) return false;
+        if (interval.count() > 0 && !pause.wait(interval)) return false;
+        count = static_cast<DWORD>((std::min)({ static_cast<size_t>(batch), static_cast<size_t>(capacity), script.size() - next }));
+        std::copy_n(script.begin() + next, count, records);
+        next += count;
+        return true;
+    }
+
+    void cancel() override { pause.cancel(); }
+    void restart() override { pause.restart(); }
+
+    void rewind() { next = 0; }
+    bool finished() const { return next >= script.size(); }
+
+private:
+    size_t next {0};
+    CancellableWait pause;
+};
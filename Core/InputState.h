@@ -1,5 +1,5 @@
 #pragma once
-#include <windows.h>
+#include "Platform.h"
 
 class InputState {
 public:
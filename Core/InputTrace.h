@@ -0,0 +1,296 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <cstdint>
+#include <algorithm>
+#include "Platform.h"
+#include "InputSource.h"
+
+// Запись ввода в компактный двоичный след и его воспроизведение.
+// Формат (little-endian):
+//   заголовок - "WUIT", версия (1 байт), 3 байта резерва;
+//   пачка     - varint: нс от прошлой пачки, varint: число записей, затем записи;
+//   запись    - EventType (1 байт) и поля события; целые - varint, знаковые (координаты) - zigzag.
+// Одна пачка - один вызов InputSource::read, время - момент, когда read вернул записи.
+// Движение мыши занимает около 8 байт вместо sizeof(INPUT_RECORD) = 20.
+class InputTrace {
+public:
+    struct Batch {
+        std::chrono::nanoseconds at;    // От начала записи
+        size_t first;                   // Индекс в records
+        size_t count;
+    };
+
+    std::vector<Batch> batches;
+    std::vector<INPUT_RECORD> records;
+
+    static constexpr char magic[4] = { 'W', 'U', 'I', 'T' };
+    static constexpr uint8_t version = 1;
+
+    void append(std::chrono::nanoseconds at, const INPUT_RECORD* src, size_t count) {
+        batches.push_back({ at, records.size(), count });
+        records.insert(records.end(), src, src + count);
+    }
+
+    std::chrono::nanoseconds duration() const { return batches.empty() ? std::chrono::nanoseconds(0) : batches.back().at; }
+
+    void clear() {
+        batches.clear();
+        records.clear();
+    }
+
+    // Весь след целиком; false - не след, другая версия или файл обрезан
+    // (тогда в trace остаются полные пачки до обрыва)
+    bool load(std::istream& in) {
+        clear();
+        char head[8];
+        if (!in.read(head, sizeof(head)) || !std::equal(magic, magic + 4, head) || static_cast<uint8_t>(head[4]) != version) return false;
+        std::chrono::nanoseconds at {0};
+        uint64_t delta;
+        while (readVarint(in, delta)) {
+            uint64_t count;
+            if (!readVarint(in, count)) return false;
+            at += std::chrono::nanoseconds(static_cast<int64_t>(delta));
+            size_t first = records.size();
+            for (uint64_t i = 0; i < count; ++i) {
+                INPUT_RECORD record {};
+                if (!readRecord(in, record)) {
+                    records.resize(first);
+                    return false;
+                }
+                records.push_back(record);
+            }
+            batches.push_back({ at, first, static_cast<size_t>(count) });
+        }
+        return in.eof();
+    }
+
+    bool save(std::ostream& out) const;
+
+    // Кодирование - общее для save() и записи на лету (RecordingInputSource)
+    static void writeHeader(std::ostream& out) {
+        char head[8] = { magic[0], magic[1], magic[2], magic[3], static_cast<char>(version), 0, 0, 0 };
+        out.write(head, sizeof(head));
+    }
+
+    static void writeBatch(std::ostream& out, std::chrono::nanoseconds delta, const INPUT_RECORD* src, size_t count) {
+        size_t known = std::count_if(src, src + count, [](const INPUT_RECORD& r) { return isKnown(r.EventType); });
+        writeVarint(out, static_cast<uint64_t>((std::max)(delta.count(), int64_t(0))));
+        writeVarint(out, known);
+        for (size_t i = 0; i < count; ++i) {
+            if (isKnown(src[i].EventType)) writeRecord(out, src[i]);
+        }
+    }
+
+private:
+    static bool isKnown(WORD type) {
+        return type == KEY_EVENT || type == MOUSE_EVENT || type == WINDOW_BUFFER_SIZE_EVENT || type == MENU_EVENT || type == FOCUS_EVENT;
+    }
+
+    static void writeVarint(std::ostream& out, uint64_t v) {
+        char buf[10];
+        int n = 0;
+        do {
+            buf[n++] = static_cast<char>((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+            v >>= 7;
+        } while (v);
+        out.write(buf, n);
+    }
+
+    static bool readVarint(std::istream& in, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int c = in.get();
+            if (c == std::char_traits<char>::eof()) return false;
+            v |= static_cast<uint64_t>(c & 0x7f) << shift;
+            if (!(c & 0x80)) return true;
+        }
+        return false;
+    }
+
+    static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    static void writeRecord(std::ostream& out, const INPUT_RECORD& r) {
+        out.put(static_cast<char>(r.EventType));
+        switch (r.EventType) {
+            case KEY_EVENT: {
+                const KEY_EVENT_RECORD& k = r.Event.KeyEvent;
+                out.put(k.bKeyDown ? 1 : 0);
+                writeVarint(out, k.wRepeatCount);
+                writeVarint(out, k.wVirtualKeyCode);
+                writeVarint(out, k.wVirtualScanCode);
+                writeVarint(out, static_cast<WORD>(k.uChar.UnicodeChar));
+                writeVarint(out, k.dwControlKeyState);
+                break;
+            }
+            case MOUSE_EVENT: {
+                const MOUSE_EVENT_RECORD& m = r.Event.MouseEvent;
+                writeVarint(out, zigzag(m.dwMousePosition.X));
+                writeVarint(out, zigzag(m.dwMousePosition.Y));
+                writeVarint(out, m.dwButtonState);
+                writeVarint(out, m.dwControlKeyState);
+                writeVarint(out, m.dwEventFlags);
+                break;
+            }
+            case WINDOW_BUFFER_SIZE_EVENT:
+                writeVarint(out, zigzag(r.Event.WindowBufferSizeEvent.dwSize.X));
+                writeVarint(out, zigzag(r.Event.WindowBufferSizeEvent.dwSize.Y));
+                break;
+            case MENU_EVENT:
+                writeVarint(out, r.Event.MenuEvent.dwCommandId);
+                break;
+            case FOCUS_EVENT:
+                out.put(r.Event.FocusEvent.bSetFocus ? 1 : 0);
+                break;
+        }
+    }
+
+    static bool readRecord(std::istream& in, INPUT_RECORD& r) {
+        int type = in.get();
+        if (type == std::char_traits<char>::eof()) return false;
+        r.EventType = static_cast<WORD>(type);
+        uint64_t a = 0, b = 0, c = 0, d = 0, e = 0;
+        switch (r.EventType) {
+            case KEY_EVENT: {
+                int down = in.get();
+                if (down == std::char_traits<char>::eof()) return false;
+                if (!readVarint(in, a) || !readVarint(in, b) || !readVarint(in, c) || !readVarint(in, d) || !readVarint(in, e)) return false;
+                KEY_EVENT_RECORD& k = r.Event.KeyEvent;
+                k.bKeyDown = down ? TRUE : FALSE;
+                k.wRepeatCount = static_cast<WORD>(a);
+                k.wVirtualKeyCode = static_cast<WORD>(b);
+                k.wVirtualScanCode = static_cast<WORD>(c);
+                k.uChar.UnicodeChar = static_cast<WCHAR>(d);
+                k.dwControlKeyState = static_cast<DWORD>(e);
+                return true;
+            }
+            case MOUSE_EVENT: {
+                if (!readVarint(in, a) || !readVarint(in, b) || !readVarint(in, c) || !readVarint(in, d) || !readVarint(in, e)) return false;
+                MOUSE_EVENT_RECORD& m = r.Event.MouseEvent;
+                m.dwMousePosition = { static_cast<SHORT>(unzigzag(a)), static_cast<SHORT>(unzigzag(b)) };
+                m.dwButtonState = static_cast<DWORD>(c);
+                m.dwControlKeyState = static_cast<DWORD>(d);
+                m.dwEventFlags = static_cast<DWORD>(e);
+                return true;
+            }
+            case WINDOW_BUFFER_SIZE_EVENT:
+                if (!readVarint(in, a) || !readVarint(in, b)) return false;
+                r.Event.WindowBufferSizeEvent.dwSize = { static_cast<SHORT>(unzigzag(a)), static_cast<SHORT>(unzigzag(b)) };
+                return true;
+            case MENU_EVENT:
+                if (!readVarint(in, a)) return false;
+                r.Event.MenuEvent.dwCommandId = static_cast<UINT>(a);
+                return true;
+            case FOCUS_EVENT: {
+                int set = in.get();
+                if (set == std::char_traits<char>::eof()) return false;
+                r.Event.FocusEvent.bSetFocus = set ? TRUE : FALSE;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+inline bool InputTrace::save(std::ostream& out) const {
+    writeHeader(out);
+    std::chrono::nanoseconds last {0};
+    for (const Batch& batch : batches) {
+        writeBatch(out, batch.at - last, records.data() + batch.first, batch.count);
+        last = batch.at;
+    }
+    return static_cast<bool>(out);
+}
+
+// Пишет в след всё, что отдаёт другой источник, и передаёт записи дальше без изменений:
+//   ConsoleInputSource console;
+//   std::ofstream file("session.wuit", std::ios::binary);
+//   RecordingInputSource recorder(console, file);
+//   EventManager::getInstance().setInputSource(&recorder);
+// След пишется по пачке сразу, так что он переживает аварийное завершение программы.
+class RecordingInputSource : public InputSource {
+public:
+    RecordingInputSource(InputSource& source, std::ostream& out) : inner(source), stream(out) {
+        InputTrace::writeHeader(stream);
+    }
+
+    bool read(INPUT_RECORD* records, DWORD capacity, DWORD& count) override {
+        if (!inner.read(records, capacity, count)) return false;
+        auto now = Clock::now();
+        if (!started) {
+            last = now;
+            started = true;
+        }
+        InputTrace::writeBatch(stream, now - last, records, count);
+        stream.flush();
+        last = now;
+        recorded += count;
+        return true;
+    }
+
+    void cancel() override { inner.cancel(); }
+    void restart() override { inner.restart(); }
+
+    size_t recordedCount() const { return recorded; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    InputSource& inner;
+    std::ostream& stream;
+    Clock::time_point last;
+    bool started {false};
+    size_t recorded {0};
+};
+
+// Воспроизведение следа: Recorded - пачки приходят с записанными промежутками,
+// AsFastAsPossible - подряд, без ожидания (регрессионный бенчмарк).
+class TraceInputSource : public InputSource {
+public:
+    enum Speed { Recorded, AsFastAsPossible };
+
+    const InputTrace& trace;
+    Speed speed;
+
+    explicit TraceInputSource(const InputTrace& t, Speed s = AsFastAsPossible) : trace(t), speed(s) {}
+
+    bool read(INPUT_RECORD* records, DWORD capacity, DWORD& count) override {
+        if (next >= trace.batches.size() || pause.cancelled()) return false;
+        const InputTrace::Batch& batch = trace.batches[next];
+        if (speed == Recorded) {
+            if (!started) {
+                start = std::chrono::steady_clock::now();
+                started = true;
+            }
+            if (!pause.until(start + batch.at)) return false;
+        }
+        // Пачка больше буфера читателя отдаётся за несколько вызовов
+        count = static_cast<DWORD>((std::min)(static_cast<size_t>(capacity), batch.count - offset));
+        std::copy_n(trace.records.begin() + batch.first + offset, count, records);
+        offset += count;
+        if (offset == batch.count) {
+            offset = 0;
+            ++next;
+        }
+        return true;
+    }
+
+    void rewind() {
+        next = offset = 0;
+        started = false;
+    }
+
+    bool finished() const { return next >= trace.batches.size(); }
+
+    void cancel() override { pause.cancel(); }
+    void restart() override { pause.restart(); }
+
+private:
+    CancellableWait pause;
+    size_t next {0};
+    size_t offset {0};
+    bool started {false};
+    std::chrono::steady_clock::time_point start;
+};
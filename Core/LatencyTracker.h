@@ -0,0 +1,259 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "Platform.h"
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+// Гистограмма задержек в наносекундах: корзины по степеням двойки, каждая поделена на 8,
+// так что перцентиль известен с точностью ~12%. Запись - O(1), без выделения памяти.
+class LatencyHistogram {
+public:
+    void record(long long ns) {
+        uint64_t v = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        buckets[index(v)]++;
+        total++;
+        if (v > peak) peak = v;
+    }
+
+    void clear() { *this = {}; }
+
+    size_t count() const { return total; }
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(peak); }
+
+    // Верхняя граница корзины, в которую попал p-й перцентиль (p от 0 до 1)
+    std::chrono::nanoseconds percentile(double p) const {
+        if (total == 0) return std::chrono::nanoseconds(0);
+        uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::chrono::nanoseconds((std::min)(upper(i), peak));
+        }
+        return max();
+    }
+
+private:
+    static constexpr int subBits = 3;
+
+    std::array<uint32_t, 64 << subBits> buckets {};
+    uint64_t total {0};
+    uint64_t peak {0};
+
+    static size_t index(uint64_t v) {
+        if (v < (1u << subBits)) return static_cast<size_t>(v);
+        int e = 63 - std::countl_zero(v);
+        return (static_cast<size_t>(e - subBits + 1) << subBits) | ((v >> (e - subBits)) & ((1u << subBits) - 1));
+    }
+
+    static uint64_t upper(size_t i) {
+        if (i < (1u << subBits)) return i;
+        int e = static_cast<int>(i >> subBits) + subBits - 1;
+        uint64_t lower = ((1ull << subBits) | (i & ((1u << subBits) - 1))) << (e - subBits);
+        return lower + (1ull << (e - subBits)) - 1;
+    }
+};
+
+// Отметка записи ввода: когда её прочитали и какого она типа
+struct InputStamp {
+    long long ns {0};   // LatencyTracker::now() в момент чтения; 0 - нет отметки
+    WORD type {0};      // EventType записи
+
+    explicit operator bool() const { return ns != 0; }
+};
+
+struct LatencyRow {
+    std::string name;               // Тип события или класс элемента
+    size_t count {0};
+    std::chrono::nanoseconds p50 {0};
+    std::chrono::nanoseconds p99 {0};
+    std::chrono::nanoseconds max {0};
+};
+
+struct LatencyReport {
+    std::vector<LatencyRow> dispatch;       // Чтение -> начало обработчиков, по типу события
+    std::vector<LatencyRow> paintByEvent;   // Чтение -> кадр на экране, по типу события
+    std::vector<LatencyRow> paintByClass;   // Чтение -> кадр на экране, по классу перерисованного элемента
+};
+
+// Задержка от ввода до кадра.
+// Поток чтения EventManager помечает каждую запись моментом чтения; диспетчер, раздавая запись,
+// делает её текущей (beginInput). Элемент, который обработчик пометил invalidate(), запоминает
+// самую раннюю текущую запись (FrameScheduler), при draw() отметка переходит в кадр (drawn),
+// а когда кадр выведен (Render::present) - задержка записывается в гистограммы
+// по типу события и по классу элемента. Медленный виджет виден по своей строке в paintByClass.
+// Одна запись, перерисовавшая несколько элементов, в paintByEvent считается один раз.
+// Ввод, после которого ничего не перерисовалось, попадает только в dispatch.
+class LatencyTracker {
+public:
+    // false - отметки не ставятся и не пишутся (по часам на запись меньше)
+    static inline std::atomic<bool> enabled {true};
+
+    static long long now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Диспетчер: обработчики, вызванные до endInput(), работают над этой записью
+    static void beginInput(WORD type, long long readNs) {
+        if (!enabled.load(std::memory_order_relaxed)) return;
+        current = { readNs, type };
+        long long wait = now() - readNs;
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().dispatch[slot(type)].record(wait);
+    }
+
+    static void endInput() { current = {}; }
+
+    // Запись, которую сейчас разбирает этот поток
+    static InputStamp currentInput() { return current; }
+
+    // Элемент стал недействительным: в stamp остаётся самая ранняя запись, которую он ждёт
+    static void mark(InputStamp& stamp) {
+        if (current && (!stamp || current.ns < stamp.ns)) stamp = current;
+    }
+
+    // Элемент класса cls нарисован по записи stamp; задержка посчитается при выводе кадра
+    static void drawn(const std::type_info& cls, InputStamp stamp) {
+        if (!stamp) return;
+        std::lock_guard<std::mutex> lock(state().mutex);
+        state().unpresented.push_back({ std::type_index(cls), stamp });
+        state().hasUnpresented.store(true, std::memory_order_relaxed);
+    }
+
+    // Кадр ушёл в бэкенд (зовёт Render::present)
+    static void presented() {
+        if (!state().hasUnpresented.load(std::memory_order_relaxed)) return;
+        long long at = now();
+        std::lock_guard<std::mutex> lock(state().mutex);
+        auto& frame = state().unpresented;
+        for (const Drawn& d : frame) state().byClass[d.cls].record(at - d.stamp.ns);
+        std::sort(frame.begin(), frame.end(), [](const Drawn& a, const Drawn& b) { return a.stamp.ns < b.stamp.ns || (a.stamp.ns == b.stamp.ns && a.stamp.type < b.stamp.type); });
+        for (size_t i = 0; i < frame.size(); ++i) {
+            if (i > 0 && frame[i].stamp.ns == frame[i - 1].stamp.ns && frame[i].stamp.type == frame[i - 1].stamp.type) continue;
+            state().byEvent[slot(frame[i].stamp.type)].record(at - frame[i].stamp.ns);
+        }
+        frame.clear();
+        state().hasUnpresented.store(false, std::memory_order_relaxed);
+    }
+
+    static LatencyReport report() {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        LatencyReport r;
+        for (size_t i = 0; i < eventSlots; ++i) {
+            if (state().dispatch[i].count()) r.dispatch.push_back(row(eventName(i), state().dispatch[i]));
+            if (state().byEvent[i].count()) r.paintByEvent.push_back(row(eventName(i), state().byEvent[i]));
+        }
+        for (const auto& [cls, histogram] : state().byClass) r.paintByClass.push_back(row(className(cls), histogram));
+        // Самые медленные элементы - первыми
+        std::sort(r.paintByClass.begin(), r.paintByClass.end(), [](const LatencyRow& a, const LatencyRow& b) { return a.p99 > b.p99; });
+        return r;
+    }
+
+    static void dump(std::ostream& out) {
+        LatencyReport r = report();
+        out << "input latency, us" << std::endl;
+        table(out, "read -> dispatch", r.dispatch);
+        table(out, "read -> present, by event", r.paintByEvent);
+        table(out, "read -> present, by control", r.paintByClass);
+    }
+
+    static void reset() {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        for (auto& h : state().dispatch) h.clear();
+        for (auto& h : state().byEvent) h.clear();
+        state().byClass.clear();
+        state().unpresented.clear();
+        state().hasUnpresented = false;
+    }
+
+    // При выходе из программы вывести dump() в out (nullptr - не выводить)
+    static void dumpOnExit(std::ostream* out = &std::cerr) { state().exitOut = out; }
+
+private:
+    static constexpr size_t eventSlots = 6;
+
+    struct Drawn {
+        std::type_index cls;
+        InputStamp stamp;
+    };
+
+    // Всё состояние одним объектом: дамп при выходе идёт из его деструктора, пока гистограммы живы
+    struct State {
+        std::mutex mutex;
+        std::array<LatencyHistogram, eventSlots> dispatch;
+        std::array<LatencyHistogram, eventSlots> byEvent;
+        std::unordered_map<std::type_index, LatencyHistogram> byClass;
+        std::vector<Drawn> unpresented;         // Нарисовано, но кадр ещё не выведен
+        std::atomic<bool> hasUnpresented {false};
+        std::ostream* exitOut {nullptr};
+
+        ~State() {
+            if (exitOut) dump(*exitOut);
+        }
+    };
+
+    static inline thread_local InputStamp current;
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static size_t slot(WORD type) {
+        switch (type) {
+            case KEY_EVENT: return 0;
+            case MOUSE_EVENT: return 1;
+            case WINDOW_BUFFER_SIZE_EVENT: return 2;
+            case MENU_EVENT: return 3;
+            case FOCUS_EVENT: return 4;
+            default: return 5;
+        }
+    }
+
+    static const char* eventName(size_t slot) {
+        static const char* names[eventSlots] = { "key", "mouse", "resize", "menu", "focus", "other" };
+        return names[slot];
+    }
+
+    static std::string className(std::type_index cls) {
+        std::string name = cls.name();
+#if defined(__GNUG__)
+        int status = 0;
+        char* plain = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+        if (status == 0 && plain) name = plain;
+        std::free(plain);
+#else
+        if (name.rfind("class ", 0) == 0) name.erase(0, 6);     // MSVC: "class Button"
+#endif
+        return name;
+    }
+
+    static LatencyRow row(std::string name, const LatencyHistogram& h) {
+        return { std::move(name), h.count(), h.percentile(0.5), h.percentile(0.99), h.max() };
+    }
+
+    static void table(std::ostream& out, const char* title, const std::vector<LatencyRow>& rows) {
+        out << std::left << std::setw(30) << title << std::right << std::setw(10) << "count"
+            << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+        auto us = [](std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1e3; };
+        for (const LatencyRow& r : rows) {
+            out << "  " << std::left << std::setw(28) << r.name << std::right << std::setw(10) << r.count
+                << std::fixed << std::setprecision(1) << std::setw(10) << us(r.p50) << std::setw(10) << us(r.p99)
+                << std::setw(10) << us(r.max) << std::defaultfloat << std::endl;
+        }
+    }
+};
@@ -0,0 +1,205 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Platform.h"
+#include "Control.h"
+#include "FocusManager.h"
+
+struct RouterStats {
+    size_t events {0};          // События мыши, прошедшие через route()
+    size_t deliveries {0};      // Вызовы Control::onMouse
+    size_t hoverChanges {0};    // Смены набора элементов под курсором
+};
+
+// Маршрутизация мыши через пространственный индекс.
+// Вместо рассылки каждого события всем элементам (по обработчику на элемент в EventManager)
+// элементы регистрируются здесь, а событие получают только:
+// - элементы под курсором (элемент и содержащие его контейнеры, например ScrollContainer для колеса);
+// - элементы, с которых курсор только что ушёл (снять подсветку);
+// - при нажатии кнопки - элемент в фокусе, если он не под курсором (снять фокус).
+// Индекс - равномерная сетка клеток cellWidth x cellHeight; в клетке - элементы, чьи rect её задевают.
+// После изменения rect элемента нужно вызвать update() (Container::rearrangeControls и прокрутка
+// ScrollContainer делают это сами).
+class MouseRouter {
+public:
+    static constexpr SHORT cellWidth = 16;
+    static constexpr SHORT cellHeight = 4;
+
+    static inline RouterStats stats;
+
+    // Элемент начинает получать мышь; повторный вызов - то же, что update()
+    static void add(Control* ctrl) {
+        if (ctrl->routeSlot >= 0) {
+            update(ctrl);
+            return;
+        }
+        State& s = state();
+        int slot;
+        if (!s.freeSlots.empty()) {
+            slot = s.freeSlots.back();
+            s.freeSlots.pop_back();
+        } else {
+            slot = static_cast<int>(s.entries.size());
+            s.entries.emplace_back();
+        }
+        s.entries[slot] = { ctrl, ctrl->rect, s.nextOrder++ };
+        ctrl->routeSlot = slot;
+        insert(s.entries[slot]);
+    }
+
+    static void remove(Control* ctrl) {
+        if (ctrl->routeSlot < 0) return;
+        State& s = state();
+        Entry& entry = s.entries[ctrl->routeSlot];
+        erase(entry);
+        s.freeSlots.push_back(ctrl->routeSlot);
+        entry = {};
+        ctrl->routeSlot = -1;
+        s.hovered.erase(std::remove(s.hovered.begin(), s.hovered.end(), ctrl), s.hovered.end());
+        // Элемент удалён обработчиком текущего события - больше его не вызываем
+        std::replace(s.targets.begin(), s.targets.end(), ctrl, static_cast<Control*>(nullptr));
+    }
+
+    // rect элемента изменился
+    static void update(Control* ctrl) {
+        if (ctrl->routeSlot < 0) return;
+        State& s = state();
+        Entry& entry = s.entries[ctrl->routeSlot];
+        if (sameRect(entry.indexed, ctrl->rect)) return;
+        erase(entry);
+        entry.indexed = ctrl->rect;
+        insert(entry);
+    }
+
+    static void clear() {
+        State& s = state();
+        for (Entry& entry : s.entries) if (entry.ctrl) entry.ctrl->routeSlot = -1;
+        s.entries.clear();
+        s.freeSlots.clear();
+        for (auto& cell : s.grid) cell.clear();
+        s.hovered.clear();
+        std::fill(s.targets.begin(), s.targets.end(), nullptr);
+    }
+
+    static size_t size() { return state().entries.size() - state().freeSlots.size(); }
+
+    // Элементы под точкой в порядке регистрации; часть элемента, отрезанная предками
+    // (окном ScrollContainer), и скрытые элементы мышь не получают
+    static void hitTest(COORD pos, std::vector<Control*>& out) {
+        out.clear();
+        if (pos.X < 0 || pos.Y < 0) return;
+        const State& s = state();
+        int cx = pos.X / cellWidth, cy = pos.Y / cellHeight;
+        if (cx >= s.gridWidth || cy >= s.gridHeight) return;
+        for (const Item& item : s.grid[static_cast<size_t>(cy) * s.gridWidth + cx]) {
+            if (item.ctrl->isHovered(pos)) out.push_back(item.ctrl);
+        }
+    }
+
+    static void route(const MOUSE_EVENT_RECORD& mer) {
+        stats.events++;
+        State& s = state();
+        hitTest(mer.dwMousePosition, s.hits);
+
+        s.targets.clear();
+        // Курсор ушёл - элемент получает событие, чтобы снять подсветку
+        for (Control* ctrl : s.hovered) {
+            if (std::find(s.hits.begin(), s.hits.end(), ctrl) == s.hits.end()) s.targets.push_back(ctrl);
+        }
+        if (s.targets.size() || s.hits.size() != s.hovered.size()) stats.hoverChanges++;
+        s.targets.insert(s.targets.end(), s.hits.begin(), s.hits.end());
+        s.hovered.assign(s.hits.begin(), s.hits.end());
+
+        // Нажатие мимо элемента в фокусе снимает с него фокус
+        bool pressed = mer.dwButtonState != 0 && (mer.dwEventFlags == 0 || mer.dwEventFlags == DOUBLE_CLICK);
+        if (pressed) {
+            Control* focused = FocusManager::focusedControl();
+            if (focused && focused->routeSlot >= 0 && std::find(s.targets.begin(), s.targets.end(), focused) == s.targets.end()) {
+                s.targets.push_back(focused);
+            }
+        }
+
+        // Обработчик может удалить элементы: remove()/clear() обнуляют их в targets
+        for (size_t i = 0; i < s.targets.size(); ++i) {
+            if (!s.targets[i]) continue;
+            stats.deliveries++;
+            s.targets[i]->onMouse(mer);
+        }
+        s.targets.clear();
+    }
+
+private:
+    struct Entry {
+        Control* ctrl {nullptr};
+        SMALL_RECT indexed {0, 0, -1, -1};  // rect, по которому элемент лежит в сетке
+        uint64_t order {0};                 // Порядок регистрации: в нём элементы получают события
+    };
+    struct Item {
+        uint64_t order;
+        Control* ctrl;
+    };
+
+    // Состояние не разрушается при выходе из программы: элементы из статических контейнеров
+    // (FocusManager) разрушаются позже него и в ~Control снимаются с учёта здесь
+    struct State {
+        std::vector<Entry> entries;
+        std::vector<int> freeSlots;
+        std::vector<std::vector<Item>> grid;
+        int gridWidth {0};
+        int gridHeight {0};
+        uint64_t nextOrder {0};
+
+        std::vector<Control*> hovered;  // Под курсором после прошлого события
+        std::vector<Control*> hits;
+        std::vector<Control*> targets;  // Получатели текущего события
+    };
+
+    static State& state() {
+        static State* s = new State;
+        return *s;
+    }
+
+    static bool sameRect(const SMALL_RECT& a, const SMALL_RECT& b) {
+        return a.Left == b.Left && a.Top == b.Top && a.Right == b.Right && a.Bottom == b.Bottom;
+    }
+
+    // Клетки, которые задевает rect; отрицательные координаты курсору недоступны и отрезаются
+    template <typename Fn>
+    static void forCells(const SMALL_RECT& r, Fn&& fn) {
+        if (r.Right < 0 || r.Bottom < 0 || r.Right < r.Left || r.Bottom < r.Top) return;
+        int x0 = (std::max)(0, static_cast<int>(r.Left)) / cellWidth, x1 = r.Right / cellWidth;
+        int y0 = (std::max)(0, static_cast<int>(r.Top)) / cellHeight, y1 = r.Bottom / cellHeight;
+        grow(x1 + 1, y1 + 1);
+        State& s = state();
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x) fn(s.grid[static_cast<size_t>(y) * s.gridWidth + x]);
+    }
+
+    static void insert(const Entry& entry) {
+        Item item { entry.order, entry.ctrl };
+        forCells(entry.indexed, [&](std::vector<Item>& cell) {
+            auto at = std::upper_bound(cell.begin(), cell.end(), item, [](const Item& a, const Item& b) { return a.order < b.order; });
+            cell.insert(at, item);
+        });
+    }
+
+    static void erase(const Entry& entry) {
+        forCells(entry.indexed, [&](std::vector<Item>& cell) {
+            cell.erase(std::remove_if(cell.begin(), cell.end(), [&](const Item& item) { return item.ctrl == entry.ctrl; }), cell.end());
+        });
+    }
+
+    // Сетка растёт под самый дальний rect; содержимое переносится в новые координаты клеток
+    static void grow(int width, int height) {
+        State& s = state();
+        if (width <= s.gridWidth && height <= s.gridHeight) return;
+        int w = (std::max)(width, s.gridWidth), h = (std::max)(height, s.gridHeight);
+        std::vector<std::vector<Item>> next(static_cast<size_t>(w) * h);
+        for (int y = 0; y < s.gridHeight; ++y)
+            for (int x = 0; x < s.gridWidth; ++x) next[static_cast<size_t>(y) * w + x] = std::move(s.grid[static_cast<size_t>(y) * s.gridWidth + x]);
+        s.grid = std::move(next);
+        s.gridWidth = w;
+        s.gridHeight = h;
+    }
+};
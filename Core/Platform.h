@@ -0,0 +1,9 @@
+#pragma once
+// Единая точка подключения WinAPI.
+// Под Windows это обычный <windows.h>, на остальных платформах - консоль-заглушка
+// в памяти (ConsoleStub.h), чтобы библиотеку можно было собирать и профилировать на Linux.
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "ConsoleStub.h"
+#endif
@@ -1,31 +1,181 @@
 #pragma once
-#include <windows.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include "Platform.h"
+#include "Surface.h"
+#include "RenderBackend.h"
+#include "Win32Backend.h"
+#include "CharWidth.h"
+#include "TextLayout.h"
+#include "LatencyTracker.h"
+
+struct RenderStats {
+    size_t presents {0};                 // Сколько раз буфер выводился в бэкенд
+    size_t cellsPresented {0};           // Сколько ячеек было выведено
+    size_t runsPresented {0};            // Сколько отрезков строк (вызовов вывода)
+    size_t lastFrameCells {0};           // Ячеек в последнем кадре
+    size_t scrolls {0};                  // Сдвиги уже нарисованного (scrollArea)
+    std::chrono::nanoseconds presentTime {0};
+};
+
 class Render {
 public:
     inline static HANDLE hout { GetStdHandle(STD_OUTPUT_HANDLE) };
     WORD attr {FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE};
-    inline static DWORD dump {0};
-    static CONSOLE_SCREEN_BUFFER_INFO csbi;
+    inline static CONSOLE_SCREEN_BUFFER_INFO csbi {};
+    inline static WORD defaultAttr {FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE};
     wchar_t fillChar {L' '};
 
+    // Задний буфер. nullptr - прямой режим, каждый примитив сразу уходит в бэкенд.
+    inline static Surface* surface {nullptr};
+
+    inline static RenderStats stats;
+
+    // Кадр: пока жив хотя бы один Frame, примитивы только накапливают изменения в буфере,
+    // а при разрушении внешнего кадра всё выводится одним present().
+    class Frame {
+    public:
+        Frame() { ++depth; }
+        ~Frame() { if (--depth == 0) present(); }
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    };
+
+    // Область отсечения: пока жив Clip, примитивы пишут только в пересечение его прямоугольника
+    // с внешними (перерисовка повреждённой области дерева элементов, см. FrameScheduler).
+    class Clip {
+    public:
+        explicit Clip(const SMALL_RECT& r) : saved(clip), savedOn(clipping) {
+            clip = clipping ? intersect(clip, r) : r;
+            clipping = true;
+        }
+        ~Clip() {
+            clip = saved;
+            clipping = savedOn;
+        }
+        Clip(const Clip&) = delete;
+        Clip& operator=(const Clip&) = delete;
+    private:
+        SMALL_RECT saved;
+        bool savedOn;
+    };
+
+    static SMALL_RECT intersect(const SMALL_RECT& a, const SMALL_RECT& b) {
+        return { (std::max)(a.Left, b.Left), (std::max)(a.Top, b.Top), (std::min)(a.Right, b.Right), (std::min)(a.Bottom, b.Bottom) };
+    }
+
+    static bool intersects(const SMALL_RECT& a, const SMALL_RECT& b) {
+        return a.Left <= b.Right && b.Left <= a.Right && a.Top <= b.Bottom && b.Top <= a.Bottom;
+    }
+
+    // Куда уходит отрисовка. По умолчанию - консоль Windows (вне Windows - ConsoleStub).
+    static RenderBackend& backend() {
+        if (!current) {
+            static Win32Backend console(hout);
+            current = &console;
+        }
+        return *current;
+    }
+
+    // Подменяет бэкенд (VtBackend, HeadlessBackend, ...). Задний буфер подгоняется под его размер.
+    static void setBackend(RenderBackend* b) {
+        current = b;
+        if (surface) enableBackBuffer();
+    }
+
+    // Включает режим заднего буфера размером с экран бэкенда.
+    // Экран очищается, чтобы его содержимое совпадало с front-буфером для сравнения кадров.
+    static void enableBackBuffer() {
+        static Surface backBuffer(backend().size());
+        surface = &backBuffer;
+        clearScreen();
+    }
+
+    static void disableBackBuffer() {
+        present();
+        surface = nullptr;
+    }
+
+    static void present() {
+        if (surface && surface->isDirty()) {
+            auto start = std::chrono::steady_clock::now();
+            PresentResult frame = surface->present(backend());
+            stats.cellsPresented += frame.cells;
+            stats.runsPresented += frame.runs;
+            stats.lastFrameCells = frame.cells;
+            stats.presents++;
+            stats.presentTime += std::chrono::steady_clock::now() - start;
+        }
+        backend().flush();
+        LatencyTracker::presented();
+    }
+
+    // Сдвигает уже нарисованное в area на dy строк (вниз - больше нуля); открывшиеся строки надо
+    // перерисовать. Без заднего буфера - только если бэкенд сдвигает экран сам; false - перерисовать всё
+    static bool scrollArea(const SMALL_RECT& area, SHORT dy) {
+        const Cell fill { L' ', defaultAttr };
+        if (surface ? !surface->scroll(area, dy, backend(), fill) : !backend().scrollRect(area, dy, fill)) return false;
+        stats.scrolls++;
+        return true;
+    }
+
     void DrawBox(SMALL_RECT& rect) {
+        drawBorder(rect, attr);
+    }
+
+    void fillBox(SMALL_RECT& rect, bool withBorder = false) {
+        fillRect({ static_cast<SHORT>(rect.Left + withBorder), static_cast<SHORT>(rect.Top + withBorder),
+                   static_cast<SHORT>(rect.Right - withBorder), static_cast<SHORT>(rect.Bottom - withBorder) }, fillChar, attr);
+    }
+
+    // Горизонтальный отрезок из одного символа: одна операция бэкенда на отрезок
+    static void fillRun(COORD pos, SHORT length, wchar_t ch, WORD color) {
+        putRun(pos, length, ch, color);
+        autoPresent();
+    }
+
+    // Прямоугольник построчно: по отрезку на строку
+    static void fillRect(const SMALL_RECT& area, wchar_t ch, WORD color) {
+        SMALL_RECT rect = clipping ? intersect(area, clip) : area;
+        if (rect.Right < rect.Left || rect.Bottom < rect.Top) return;
+        if (surface) {
+            surface->fill(rect, ch, color);
+        } else {
+            for (SHORT y = rect.Top; y <= rect.Bottom; ++y) putRun({ rect.Left, y }, rect.Right - rect.Left + 1, ch, color);
+        }
+        autoPresent();
+    }
+
+    // Рамка четырьмя отрезками: верхняя и нижняя строки с углами, левый и правый столбцы
+    static void drawBorder(const SMALL_RECT& rect, WORD color) {
         // Unicode Box Drawing characters
-        #define hline   L"\u2500"  // ─
-        #define vline   L"\u2502"  // │
-        #define tl L"\u250C" // ┌
-        #define tr L"\u2510" // ┐
-        #define bl L"\u2514" // └
-        #define br L"\u2518" // ┘
-        WriteConsoleOutputCharacterW(hout, tl, 1, { rect.Left, rect.Top }, &dump);
-        for (SHORT x = rect.Left + 1; x < rect.Right; x++) WriteConsoleOutputCharacterW(hout, hline, 1, { x, rect.Top }, &dump);
-        WriteConsoleOutputCharacterW(hout, tr, 1, { rect.Right, rect.Top }, &dump);
-        for (SHORT y = rect.Top + 1; y < rect.Bottom; y++) {
-            WriteConsoleOutputCharacterW(hout, vline, 1, { rect.Left, y }, &dump);
-            WriteConsoleOutputCharacterW(hout, vline, 1, { rect.Right, y }, &dump);
+        #define hline   L'\u2500'  // ─
+        #define vline   L'\u2502'  // │
+        #define tl L'\u250C' // ┌
+        #define tr L'\u2510' // ┐
+        #define bl L'\u2514' // └
+        #define br L'\u2518' // ┘
+        const SHORT width = rect.Right - rect.Left + 1;
+        const SHORT height = rect.Bottom - rect.Top + 1;
+        if (width <= 0 || height <= 0) return;
+
+        scratch.assign(width, Cell{ hline, color });
+        scratch.front().ch = tl;
+        scratch.back().ch = tr;
+        putCells({ rect.Left, rect.Top }, scratch.data(), width);
+        scratch.front().ch = bl;
+        scratch.back().ch = br;
+        putCells({ rect.Left, rect.Bottom }, scratch.data(), width);
+
+        if (height > 2) {
+            scratch.assign(height - 2, Cell{ vline, color });
+            putColumn({ rect.Left, static_cast<SHORT>(rect.Top + 1) }, scratch.data(), height - 2);
+            putColumn({ rect.Right, static_cast<SHORT>(rect.Top + 1) }, scratch.data(), height - 2);
         }
-        WriteConsoleOutputCharacterW(hout, bl, 1, { rect.Left, rect.Bottom }, &dump);
-        for (SHORT x = rect.Left + 1; x < rect.Right; x++) WriteConsoleOutputCharacterW(hout, hline, 1, { x, rect.Bottom }, &dump);
-        WriteConsoleOutputCharacterW(hout, br, 1, { rect.Right, rect.Bottom }, &dump);
+        autoPresent();
         #undef hline
         #undef vline
         #undef tl
@@ -34,50 +184,137 @@ public:
         #undef br
     }
 
-    void fillBox(SMALL_RECT& rect, bool withBorder = false) {
-        for (SHORT y = rect.Top + withBorder; y <= rect.Bottom - withBorder; y++) {
-            for (SHORT x = rect.Left + withBorder; x <= rect.Right - withBorder; x++) {
-                FillConsoleOutputAttribute(hout, attr, 1, { x, y }, &dump);
-                WriteConsoleOutputCharacterW(hout, &fillChar, 1, { x, y }, &dump);
-            }
+    static void clearScreen() {
+        RenderBackend& b = backend();
+        csbi.dwSize = b.size();
+        b.clear(defaultAttr);
+        b.setCursor({ 0, 0 });
+        b.flush();
+        if (surface) {
+            if (surface->getSize().X != csbi.dwSize.X || surface->getSize().Y != csbi.dwSize.Y) surface->resize(csbi.dwSize);
+            surface->reset(L' ', defaultAttr);
         }
     }
 
-    static void clearScreen() {
-        GetConsoleScreenBufferInfo(hout, &csbi);
-        FillConsoleOutputAttribute(hout, csbi.wAttributes, csbi.dwSize.X * csbi.dwSize.Y, { 0, 0 }, &dump);
-        FillConsoleOutputCharacter(hout, (TCHAR)' ', csbi.dwSize.X * csbi.dwSize.Y, { 0, 0 }, &dump);
-        SetConsoleCursorPosition(hout, { 0, 0 });
+    static void updateConsoleBufferSize(COORD dsize) {
+        backend().resize(dsize);
+        if (surface) surface->resize(dsize);
     }
 
-    static void updateConsoleBufferSize(COORD dsize) {
-        GetConsoleScreenBufferInfo(hout, &csbi);
-        SMALL_RECT sr = { 0, 0, static_cast<short>(csbi.dwSize.X + 1), static_cast<short>(csbi.dwSize.Y + 1) };
-        SetConsoleScreenBufferSize(hout, dsize);
-        SetConsoleWindowInfo(hout, true, &sr);
+
+
+    // Расчёт центрирования текста. Ширина - в столбцах экрана (CharWidth), а не в wchar_t
+    inline void drawTextCentered(const std::wstring& text, const SMALL_RECT& rect) {
+        writeAligned(text, rect, TextLayout::Align::Center);
+    }
+    inline void drawTextLeft(const std::wstring& text, const SMALL_RECT& rect) {
+        writeAligned(text, rect, TextLayout::Align::Left);
     }
 
-  
+    inline void drawTextRight(const std::wstring& text, const SMALL_RECT& rect) {
+        writeAligned(text, rect, TextLayout::Align::Right);
+    }
 
-    // Расчёт центрирования текста
-    inline void drawTextCentered(const std::wstring& text, const SMALL_RECT& rect) { 
-        if (static_cast<size_t>(rect.Right - rect.Left) < text.size()) WriteConsoleOutputCharacterW(hout, L"...", 3, { static_cast<SHORT>(rect.Left + (rect.Right - rect.Left + 1 - 3) / 2), static_cast<SHORT>((rect.Top + rect.Bottom) / 2) }, &dump);
-        else WriteConsoleOutputCharacterW(hout, text.c_str(), text.size(), { static_cast<SHORT>(rect.Left + ((rect.Right - rect.Left + 1 - text.size()) / 2)), static_cast<SHORT>((rect.Top + rect.Bottom) / 2) }, &dump); 
+    // Заранее разложенная подпись контрола (см. TextLayout) с текущим атрибутом
+    inline void drawLayout(TextLayout& layout) {
+        layout.setAttr(attr);
+        putCells(layout.origin(), layout.data(), layout.length());
+        autoPresent();
     }
-    inline void drawTextLeft(const std::wstring& text, const SMALL_RECT& rect) { 
-        if (static_cast<size_t>(rect.Right - rect.Left) < text.size()) WriteConsoleOutputCharacterW(hout, L"...", 3, { static_cast<SHORT>(rect.Left + (rect.Right - rect.Left + 1 - 3) / 2), static_cast<SHORT>((rect.Top + rect.Bottom) / 2) }, &dump);
-        else WriteConsoleOutputCharacterW(hout, text.c_str(), text.size(), { static_cast<SHORT>(rect.Left + 1), static_cast<SHORT>((rect.Top + rect.Bottom) / 2) }, &dump); 
+
+    // Текст с текущим атрибутом начиная с pos, без выравнивания
+    inline void drawText(const std::wstring& text, const COORD& pos) {
+        writeText(text.c_str(), text.size(), pos);
     }
 
-    inline void drawTextRight(const std::wstring& text, const SMALL_RECT& rect) { 
-        if (static_cast<size_t>(rect.Right - rect.Left) < text.size()) WriteConsoleOutputCharacterW(hout, L"...", 3, { static_cast<SHORT>(rect.Left + (rect.Right - rect.Left + 1 - 3) / 2), static_cast<SHORT>((rect.Top + rect.Bottom) / 2) }, &dump);
-        else WriteConsoleOutputCharacterW(hout, text.c_str(), text.size(), { static_cast<SHORT>(rect.Right - text.size()), static_cast<SHORT>((rect.Top + rect.Bottom) / 2) }, &dump); 
+    // Готовые ячейки (у каждой свой атрибут) одним отрезком строки
+    static void drawCells(const COORD& pos, const Cell* cells, SHORT length) {
+        putCells(pos, cells, length);
+        autoPresent();
     }
 
     inline void drawChar(const COORD& pos, wchar_t ch, WORD color = 0x07) {
-        FillConsoleOutputAttribute(hout, color, 1, pos, &dump);
-        WriteConsoleOutputCharacterW(hout, &ch, 1, pos, &dump);
+        putCell(pos, ch, color);
+        autoPresent();
+    }
+
+private:
+    inline static int depth {0};
+    inline static RenderBackend* current {nullptr};
+    inline static std::vector<Cell> scratch;    // Строка текста/столбец рамки, переиспользуется между вызовами
+    inline static SMALL_RECT clip {};           // Текущая область отсечения (см. Clip)
+    inline static bool clipping {false};
+
+    // Вне кадра буфер выводится сразу после примитива, чтобы прямой вызов draw() был виден
+    static void autoPresent() { if (depth == 0) present(); }
+
+    static void putCell(COORD pos, wchar_t ch, WORD color) {
+        if (clipping && !intersects({ pos.X, pos.Y, pos.X, pos.Y }, clip)) return;
+        if (surface) {
+            surface->put(pos, ch, color);
+            return;
+        }
+        Cell cell { ch, color };
+        backend().writeRun(pos, &cell, 1);
+    }
+
+    static void putRun(COORD pos, SHORT length, wchar_t ch, WORD color) {
+        if (clipping) clipRow(pos, length);
+        if (length <= 0) return;
+        if (surface) {
+            surface->fill({ pos.X, pos.Y, static_cast<SHORT>(pos.X + length - 1), pos.Y }, ch, color);
+            return;
+        }
+        backend().fillRun(pos, Cell{ ch, color }, length);
+    }
+
+    static void putCells(COORD pos, const Cell* cells, SHORT length) {
+        if (clipping) cells += clipRow(pos, length);
+        if (length <= 0) return;
+        if (surface) surface->putCells(pos, cells, length);
+        else backend().writeRun(pos, cells, length);
+    }
+
+    static void putColumn(COORD pos, const Cell* cells, SHORT length) {
+        if (clipping) cells += clipColumn(pos, length);
+        if (length <= 0) return;
+        if (surface) surface->putColumn(pos, cells, length);
+        else backend().writeColumn(pos, cells, length);
+    }
+
+    // Обрезают отрезок по clip: сдвигают pos, укорачивают length, возвращают число отброшенных в начале ячеек
+    static SHORT clipRow(COORD& pos, SHORT& length) {
+        if (pos.Y < clip.Top || pos.Y > clip.Bottom) {
+            length = 0;
+            return 0;
+        }
+        SHORT skip = (std::max)(SHORT(0), static_cast<SHORT>(clip.Left - pos.X));
+        length = static_cast<SHORT>((std::min)(pos.X + length - 1, static_cast<int>(clip.Right)) - pos.X + 1 - skip);
+        pos.X += skip;
+        return skip;
+    }
+
+    static SHORT clipColumn(COORD& pos, SHORT& length) {
+        if (pos.X < clip.Left || pos.X > clip.Right) {
+            length = 0;
+            return 0;
+        }
+        SHORT skip = (std::max)(SHORT(0), static_cast<SHORT>(clip.Top - pos.Y));
+        length = static_cast<SHORT>((std::min)(pos.Y + length - 1, static_cast<int>(clip.Bottom)) - pos.Y + 1 - skip);
+        pos.Y += skip;
+        return skip;
     }
-};
 
-CONSOLE_SCREEN_BUFFER_INFO Render::csbi; 
\ No newline at end of file
+    void writeAligned(const std::wstring& text, const SMALL_RECT& rect, TextLayout::Align align) {
+        size_t width = CharWidth::measure(text);
+        if (static_cast<size_t>(rect.Right - rect.Left) < width) writeText(L"...", 3, TextLayout::place(3, rect, TextLayout::Align::Center));
+        else writeText(text.c_str(), text.size(), TextLayout::place(width, rect, align));
+    }
+
+    void writeText(const wchar_t* text, size_t length, COORD pos) {
+        scratch.clear();
+        TextLayout::shape(text, length, attr, scratch);
+        putCells(pos, scratch.data(), static_cast<SHORT>(scratch.size()));
+        autoPresent();
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include "Platform.h"
+#include "Cell.h"
+
+// Приёмник готовых ячеек. Render и Surface рисуют только через него,
+// а реализация решает, куда ячейки уходят: консоль Windows, VT-терминал или память.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    // Размер экрана в ячейках
+    virtual COORD size() = 0;
+
+    // Отрезок одной строки начиная с pos. Ячейки за пределами экрана отбрасываются.
+    virtual void writeRun(COORD pos, const Cell* cells, SHORT length) = 0;
+
+    // Отрезок строки из одинаковых ячеек. По умолчанию - writeRun кусками по 64 ячейки.
+    virtual void fillRun(COORD pos, const Cell& cell, SHORT length) {
+        Cell chunk[64];
+        std::fill(std::begin(chunk), std::end(chunk), cell);
+        for (SHORT done = 0; done < length; ) {
+            SHORT n = std::min<SHORT>(length - done, static_cast<SHORT>(std::size(chunk)));
+            writeRun({ static_cast<SHORT>(pos.X + done), pos.Y }, chunk, n);
+            done += n;
+        }
+    }
+
+    // Столбец ячеек сверху вниз начиная с pos. По умолчанию - по отрезку на строку.
+    virtual void writeColumn(COORD pos, const Cell* cells, SHORT length) {
+        for (SHORT i = 0; i < length; ++i) writeRun({ pos.X, static_cast<SHORT>(pos.Y + i) }, cells + i, 1);
+    }
+
+    // Сдвигает содержимое прямоугольника area на dy строк внутри него самого (вниз - больше нуля),
+    // открывшиеся строки заливаются fill. false - бэкенд так не умеет (Surface тогда выводит разницу ячейками).
+    virtual bool scrollRect(const SMALL_RECT& area, SHORT dy, const Cell& fill) {
+        (void)area; (void)dy; (void)fill;
+        return false;
+    }
+
+    // Заливает весь экран пробелами с атрибутом attr
+    virtual void clear(WORD attr) = 0;
+
+    virtual void resize(COORD size) { (void)size; }
+    virtual void setCursor(COORD pos) { (void)pos; }
+
+    // Конец кадра: буферизующие реализации выводят накопленное
+    virtual void flush() {}
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Кольцевой буфер на одного писателя и одного читателя без блокировок.
+// Писатель двигает только tail, читатель - только head; каждая сторона держит копию
+// чужого индекса и перечитывает атомик, лишь когда по копии буфер кажется полным/пустым.
+// Индексы разнесены по разным строкам кэша, чтобы потоки не делили одну строку.
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Только поток-писатель. false - буфер полон
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == Capacity) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == Capacity) return false;
+        }
+        slots[t & (Capacity - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только поток-читатель. false - буфер пуст
+    bool pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) return false;
+        }
+        value = slots[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Приблизительная глубина: из третьего потока значение может уже устареть
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    alignas(64) std::atomic<size_t> head {0};
+    size_t tailCache {0};                       // Копия tail у читателя
+    alignas(64) std::atomic<size_t> tail {0};
+    size_t headCache {0};                       // Копия head у писателя
+    alignas(64) std::array<T, Capacity> slots {};
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "Platform.h"
+#include "Cell.h"
+#include "CellDiff.h"
+#include "AlignedAllocator.h"
+#include "RenderBackend.h"
+
+// Итог одного present(): сколько ячеек и отрезков реально ушло в бэкенд
+struct PresentResult {
+    size_t cells {0};
+    size_t runs {0};
+};
+
+// Задний буфер кадра.
+// Примитивы Render пишут ячейки в память (back), а present() сравнивает грязную область
+// с тем, что уже выведено (front), и отправляет в RenderBackend только изменившиеся отрезки строк.
+class Surface {
+private:
+    COORD size {0, 0};
+    std::vector<Cell, AlignedAllocator<Cell>> cells;
+    std::vector<Cell, AlignedAllocator<Cell>> front;    // Содержимое экрана после последнего present()
+    SMALL_RECT dirty {0, 0, -1, -1};
+
+public:
+    explicit Surface(COORD s) { resize(s); }
+
+    // Два изменённых отрезка, разделённые не более чем mergeGap совпадающими ячейками,
+    // выводятся одним вызовом: лишние ячейки дешевле ещё одного обращения к бэкенду.
+    SHORT mergeGap {4};
+
+    void resize(COORD s) {
+        size = s;
+        cells.assign(static_cast<size_t>(s.X) * s.Y, Cell{});
+        front = cells;
+        dirty = { 0, 0, -1, -1 };
+    }
+
+    COORD getSize() const { return size; }
+    bool contains(SHORT x, SHORT y) const { return x >= 0 && y >= 0 && x < size.X && y < size.Y; }
+    bool isDirty() const { return dirty.Right >= dirty.Left && dirty.Bottom >= dirty.Top; }
+    const SMALL_RECT& dirtyRect() const { return dirty; }
+
+    Cell& at(SHORT x, SHORT y) { return cells[static_cast<size_t>(y) * size.X + x]; }
+    const Cell& at(SHORT x, SHORT y) const { return cells[static_cast<size_t>(y) * size.X + x]; }
+
+    // Расширяет грязную область до прямоугольника (обрезанного по размеру буфера)
+    void markDirty(SHORT left, SHORT top, SHORT right, SHORT bottom) {
+        left   = std::max<SHORT>(left, 0);
+        top    = std::max<SHORT>(top, 0);
+        right  = std::min<SHORT>(right, size.X - 1);
+        bottom = std::min<SHORT>(bottom, size.Y - 1);
+        if (right < left || bottom < top) return;
+        if (!isDirty()) {
+            dirty = { left, top, right, bottom };
+            return;
+        }
+        dirty.Left   = (std::min)(dirty.Left, left);
+        dirty.Top    = (std::min)(dirty.Top, top);
+        dirty.Right  = (std::max)(dirty.Right, right);
+        dirty.Bottom = (std::max)(dirty.Bottom, bottom);
+    }
+
+    // Символ + атрибут
+    void put(COORD pos, wchar_t ch, WORD attr) {
+        if (!contains(pos.X, pos.Y)) return;
+        at(pos.X, pos.Y) = { ch, attr };
+        markDirty(pos.X, pos.Y, pos.X, pos.Y);
+    }
+
+    // Готовые ячейки одной строки
+    void putCells(COORD pos, const Cell* src, size_t length) {
+        if (pos.Y < 0 || pos.Y >= size.Y) return;
+        SHORT x = pos.X;
+        for (size_t i = 0; i < length && x < size.X; ++i, ++x) {
+            if (x >= 0) at(x, pos.Y) = src[i];
+        }
+        markDirty(pos.X, pos.Y, x - 1, pos.Y);
+    }
+
+    // Готовые ячейки одного столбца сверху вниз
+    void putColumn(COORD pos, const Cell* src, size_t length) {
+        if (pos.X < 0 || pos.X >= size.X) return;
+        SHORT y = pos.Y;
+        for (size_t i = 0; i < length && y < size.Y; ++i, ++y) {
+            if (y >= 0) at(pos.X, y) = src[i];
+        }
+        markDirty(pos.X, pos.Y, pos.X, y - 1);
+    }
+
+    void fill(const SMALL_RECT& rect, wchar_t ch, WORD attr) {
+        SHORT left   = std::max<SHORT>(rect.Left, 0);
+        SHORT top    = std::max<SHORT>(rect.Top, 0);
+        SHORT right  = std::min<SHORT>(rect.Right, size.X - 1);
+        SHORT bottom = std::min<SHORT>(rect.Bottom, size.Y - 1);
+        if (right < left) return;
+        for (SHORT y = top; y <= bottom; ++y) std::fill_n(&at(left, y), right - left + 1, Cell{ ch, attr });
+        markDirty(left, top, right, bottom);
+    }
+
+    // Сдвигает содержимое rect на dy строк внутри него самого (вниз - больше нуля); открывшиеся строки
+    // остаются прежними, пока их не перерисуют. Если бэкенд сдвинул и экран (RenderBackend::scrollRect),
+    // front сдвигается вместе с ним, и present() выведет только перерисованное; иначе - разницу ячейками.
+    // false - сдвигать нечего (rect вне экрана или сдвиг не меньше его высоты).
+    bool scroll(const SMALL_RECT& rect, SHORT dy, RenderBackend& backend, const Cell& fill) {
+        SHORT left   = std::max<SHORT>(rect.Left, 0);
+        SHORT top    = std::max<SHORT>(rect.Top, 0);
+        SHORT right  = std::min<SHORT>(rect.Right, size.X - 1);
+        SHORT bottom = std::min<SHORT>(rect.Bottom, size.Y - 1);
+        if (dy == 0 || right < left || bottom < top || std::abs(dy) > bottom - top) return false;
+        shiftRows(cells, left, top, right, bottom, dy, nullptr);
+        if (backend.scrollRect({ left, top, right, bottom }, dy, fill)) shiftRows(front, left, top, right, bottom, dy, &fill);
+        markDirty(left, top, right, bottom);
+        return true;
+    }
+
+    // Заполняет оба буфера без пометки грязной области: экран бэкенда уже очищен напрямую
+    void reset(wchar_t ch, WORD attr) {
+        std::fill(cells.begin(), cells.end(), Cell{ ch, attr });
+        front = cells;
+        dirty = { 0, 0, -1, -1 };
+    }
+
+    // Сравнивает грязную область с front и выводит только изменившиеся отрезки строк.
+    // Поиск отрезков - CellDiff (SSE2/AVX2, если доступны).
+    PresentResult present(RenderBackend& backend) {
+        PresentResult result;
+        if (!isDirty()) return result;
+        const size_t width = dirty.Right - dirty.Left + 1;
+        for (SHORT y = dirty.Top; y <= dirty.Bottom; ++y) {
+            const Cell* back = &at(dirty.Left, y);
+            Cell* shown = &front[static_cast<size_t>(y) * size.X + dirty.Left];
+            CellDiff::forEachRun(back, shown, width, static_cast<size_t>(mergeGap), [&](size_t start, size_t end) {
+                backend.writeRun({ static_cast<SHORT>(dirty.Left + start), y }, back + start, static_cast<SHORT>(end - start));
+                std::copy(back + start, back + end, shown + start);
+                result.cells += end - start;
+                result.runs++;
+            });
+        }
+        dirty = { 0, 0, -1, -1 };
+        return result;
+    }
+
+private:
+    // Строки копируются со стороны, куда идёт сдвиг; fill - чем залить открывшиеся (nullptr - не трогать)
+    void shiftRows(std::vector<Cell, AlignedAllocator<Cell>>& buffer, SHORT left, SHORT top, SHORT right, SHORT bottom, SHORT dy, const Cell* fill) {
+        const size_t width = static_cast<size_t>(right - left + 1);
+        for (int i = 0; i <= bottom - top; ++i) {
+            int y = dy > 0 ? bottom - i : top + i;
+            int from = y - dy;
+            Cell* row = &buffer[static_cast<size_t>(y) * size.X + left];
+            if (from >= top && from <= bottom) std::copy_n(&buffer[static_cast<size_t>(from) * size.X + left], width, row);
+            else if (fill) std::fill_n(row, width, *fill);
+        }
+    }
+
+};
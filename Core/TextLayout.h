@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Platform.h"
+#include "Cell.h"
+#include "CharWidth.h"
+
+// Разложенная строка подписи: ячейки уже обрезанного (или замененного на "...") текста
+// и позиция, с которой они выводятся. Хранится в контроле и пересобирается, только когда
+// меняются текст, прямоугольник или выравнивание; перерисовка по наведению лишь
+// перекрашивает готовые ячейки и не выделяет память.
+class TextLayout {
+public:
+    enum class Align : uint8_t { Left, Center, Right };
+    enum class Overflow : uint8_t {
+        Ellipsis,   // Не помещается - вместо текста "..." (как drawText*)
+        Clip        // Не помещается - обрезается по ширине прямоугольника
+    };
+
+    inline static size_t rebuilds {0};  // Сколько раз раскладка собиралась заново (все экземпляры)
+
+    TextLayout() = default;
+    explicit TextLayout(Overflow o) : overflow(o) {}
+
+    // true, если раскладка собрана заново
+    bool update(const std::wstring& text, const SMALL_RECT& rect, Align align) {
+        if (valid && align == cachedAlign && sameRect(rect, cachedRect) && text == cachedText) return false;
+        cachedText = text;
+        cachedRect = rect;
+        cachedAlign = align;
+        valid = true;
+        rebuilds++;
+
+        cells.clear();
+        size_t available = static_cast<size_t>((std::max)(rect.Right - rect.Left, 0));
+        size_t width = CharWidth::measure(text);
+        if (width <= available) {
+            shape(text.data(), text.size(), attr, cells);
+            pos = place(width, rect, align);
+        } else if (overflow == Overflow::Clip) {
+            size_t n = CharWidth::fit(text.data(), text.size(), available, &width);
+            shape(text.data(), n, attr, cells);
+            pos = place(width, rect, align);
+        } else {
+            shape(L"...", 3, attr, cells);
+            pos = place(3, rect, Align::Center);
+        }
+        return true;
+    }
+
+    // Атрибут ставится на месте: при смене выделения ячейки не пересобираются
+    void setAttr(WORD a) {
+        if (a == attr) return;
+        attr = a;
+        for (Cell& cell : cells) cell.attr = a;
+    }
+
+    void invalidate() { valid = false; }
+
+    COORD origin() const { return pos; }
+    const Cell* data() const { return cells.data(); }
+    SHORT length() const { return static_cast<SHORT>(cells.size()); }
+
+    // Начало строки шириной width столбцов в rect; вертикально - всегда средняя строка
+    static COORD place(size_t width, const SMALL_RECT& rect, Align align) {
+        SHORT y = static_cast<SHORT>((rect.Top + rect.Bottom) / 2);
+        SHORT w = static_cast<SHORT>(width);
+        switch (align) {
+            case Align::Center: return { static_cast<SHORT>(rect.Left + (rect.Right - rect.Left + 1 - w) / 2), y };
+            case Align::Right:  return { static_cast<SHORT>(rect.Right - w), y };
+            default:            return { static_cast<SHORT>(rect.Left + 1), y };
+        }
+    }
+
+    // Строка в ячейки: двойной символ - пара WideLead/WideTrail, нулевой (комбинирующие знаки) отбрасывается
+    static void shape(const wchar_t* text, size_t length, WORD attr, std::vector<Cell>& out) {
+        for (size_t i = 0; i < length; ) {
+            size_t units = 1;
+            char32_t c = CharWidth::decode(text + i, length - i, units);
+            int width = CharWidth::of(c);
+            wchar_t ch = text[i];
+            i += units;
+            if (width == 0) continue;
+            if (units > 1) {
+                // Символ вне BMP не помещается в одну 16-битную ячейку: U+FFFD и пробел до его ширины,
+                // чтобы строка заняла столько столбцов, сколько насчитали measure и fit
+                out.push_back({ L'\uFFFD', attr });
+                if (width == 2) out.push_back({ L' ', attr });
+            } else if (width == 1) out.push_back({ ch, attr });
+            else {
+                out.push_back({ ch, attr, Cell::WideLead });
+                out.push_back({ ch, attr, Cell::WideTrail });
+            }
+        }
+    }
+
+private:
+    Overflow overflow {Overflow::Ellipsis};
+    bool valid {false};
+    std::wstring cachedText;
+    SMALL_RECT cachedRect {0, 0, -1, -1};
+    Align cachedAlign {Align::Left};
+    WORD attr {FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE};
+    std::vector<Cell> cells;
+    COORD pos {0, 0};
+
+    static bool sameRect(const SMALL_RECT& a, const SMALL_RECT& b) {
+        return a.Left == b.Left && a.Top == b.Top && a.Right == b.Right && a.Bottom == b.Bottom;
+    }
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <string>
+#include "RenderBackend.h"
+#include "AnsiEncoder.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
+// Вывод в терминал escape-последовательностями ANSI/VT.
+// Кадр копится в буфере кодировщика и уходит в дескриптор одним write() в flush().
+class VtBackend : public RenderBackend {
+public:
+    struct Stats {
+        size_t bytes {0};   // Всего байт отправлено в терминал
+        size_t writes {0};  // Вызовы write()
+        size_t lastFrameBytes {0};
+    };
+    Stats stats;
+
+protected:
+    int fd;
+    COORD screenSize;
+    AnsiEncoder encoder;
+
+public:
+    // fd < 0 - никуда не писать, только считать байты (для бенчмарков)
+    explicit VtBackend(int f = 1, COORD s = { 0, 0 }) : fd(f), screenSize(s) {
+        if (screenSize.X <= 0 || screenSize.Y <= 0) screenSize = querySize();
+        encoder.resize(screenSize);
+    }
+
+    COORD size() override { return screenSize; }
+
+    // Сам вывод строит AnsiEncoder: он пропускает уже показанные ячейки,
+    // выдаёт только изменившиеся SGR-параметры и выбирает самый короткий сдвиг курсора.
+    void writeRun(COORD pos, const Cell* cells, SHORT length) override {
+        if (length <= 0) return;
+        encoder.encodeRun(pos, cells, length);
+    }
+
+    // Область прокрутки (DECSTBM) задаёт только строки, поэтому сдвигаются лишь области во всю ширину экрана
+    bool scrollRect(const SMALL_RECT& area, SHORT dy, const Cell& fill) override {
+        if (area.Left > 0 || area.Right < screenSize.X - 1) return false;
+        encoder.scrollRows(area.Top, area.Bottom, dy, fill.attr);
+        return true;
+    }
+
+    void clear(WORD attr) override { encoder.clear(attr); }
+
+    void resize(COORD s) override {
+        screenSize = s;
+        encoder.resize(s);
+    }
+
+    void setCursor(COORD pos) override { encoder.moveTo(pos); }
+
+    void flush() override {
+        std::string& out = encoder.buffer();
+        stats.lastFrameBytes = out.size();
+        if (out.empty()) return;
+        if (fd >= 0) writeAll(out.data(), out.size());
+        stats.bytes += out.size();
+        stats.writes++;
+        out.clear();
+    }
+
+    void resetStats() { stats = {}; }
+
+    // Настройки кодировщика (eraseMin, useRepeat)
+    AnsiEncoder& getEncoder() { return encoder; }
+
+protected:
+    void writeAll(const char* data, size_t length) {
+        while (length > 0) {
+#ifdef _WIN32
+            int n = _write(fd, data, static_cast<unsigned>(length));
+#else
+            ssize_t n = ::write(fd, data, length);
+#endif
+            if (n <= 0) return;
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+    }
+
+    COORD querySize() const {
+#ifdef _WIN32
+        CONSOLE_SCREEN_BUFFER_INFO csbi;
+        if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi)) {
+            return { static_cast<SHORT>(csbi.srWindow.Right - csbi.srWindow.Left + 1), static_cast<SHORT>(csbi.srWindow.Bottom - csbi.srWindow.Top + 1) };
+        }
+#else
+        winsize ws {};
+        if (fd >= 0 && ioctl(fd, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+            return { static_cast<SHORT>(ws.ws_col), static_cast<SHORT>(ws.ws_row) };
+        }
+#endif
+        return { 80, 24 };
+    }
+};
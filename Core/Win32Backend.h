@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include "RenderBackend.h"
+
+// Вывод в консоль Windows через WriteConsoleOutputW: один вызов на отрезок строки или столбец.
+// Вне Windows те же вызовы попадают в ConsoleStub и подсчитываются.
+class Win32Backend : public RenderBackend {
+private:
+    HANDLE hout;
+    DWORD dump {0};
+    std::vector<CHAR_INFO> scratch; // Переиспользуется, чтобы не аллоцировать на каждый отрезок
+
+public:
+    explicit Win32Backend(HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE)) : hout(h) {}
+
+    COORD size() override {
+        CONSOLE_SCREEN_BUFFER_INFO csbi;
+        GetConsoleScreenBufferInfo(hout, &csbi);
+        return csbi.dwSize;
+    }
+
+    void writeRun(COORD pos, const Cell* cells, SHORT length) override {
+        if (length <= 0) return;
+        toScratch(cells, length);
+        SMALL_RECT region = { pos.X, pos.Y, static_cast<SHORT>(pos.X + length - 1), pos.Y };
+        WriteConsoleOutputW(hout, scratch.data(), { length, 1 }, { 0, 0 }, &region);
+    }
+
+    void fillRun(COORD pos, const Cell& cell, SHORT length) override {
+        if (length <= 0) return;
+        scratch.assign(length, toCharInfo(cell));
+        SMALL_RECT region = { pos.X, pos.Y, static_cast<SHORT>(pos.X + length - 1), pos.Y };
+        WriteConsoleOutputW(hout, scratch.data(), { length, 1 }, { 0, 0 }, &region);
+    }
+
+    void writeColumn(COORD pos, const Cell* cells, SHORT length) override {
+        if (length <= 0) return;
+        toScratch(cells, length);
+        SMALL_RECT region = { pos.X, pos.Y, pos.X, static_cast<SHORT>(pos.Y + length - 1) };
+        WriteConsoleOutputW(hout, scratch.data(), { 1, length }, { 0, 0 }, &region);
+    }
+
+    void clear(WORD attr) override {
+        COORD s = size();
+        DWORD cells = static_cast<DWORD>(s.X) * s.Y;
+        FillConsoleOutputAttribute(hout, attr, cells, { 0, 0 }, &dump);
+        FillConsoleOutputCharacterW(hout, L' ', cells, { 0, 0 }, &dump);
+    }
+
+    // ScrollConsoleScreenBuffer: консоль сдвигает ячейки сама, без их передачи
+    bool scrollRect(const SMALL_RECT& area, SHORT dy, const Cell& fill) override {
+        CHAR_INFO blank = toCharInfo(fill);
+        COORD destination = { area.Left, static_cast<SHORT>(area.Top + dy) };
+        return ScrollConsoleScreenBufferW(hout, &area, &area, destination, &blank) != FALSE;
+    }
+
+    void resize(COORD s) override {
+        CONSOLE_SCREEN_BUFFER_INFO csbi;
+        GetConsoleScreenBufferInfo(hout, &csbi);
+        SMALL_RECT sr = { 0, 0, static_cast<short>(csbi.dwSize.X + 1), static_cast<short>(csbi.dwSize.Y + 1) };
+        SetConsoleScreenBufferSize(hout, s);
+        SetConsoleWindowInfo(hout, true, &sr);
+    }
+
+    void setCursor(COORD pos) override { SetConsoleCursorPosition(hout, pos); }
+
+private:
+    void toScratch(const Cell* cells, SHORT length) {
+        scratch.resize(length);
+        for (SHORT i = 0; i < length; ++i) scratch[i] = toCharInfo(cells[i]);
+    }
+
+    // Половинки двойного символа консоль ждёт с флагами ведущего/замыкающего байта
+    static CHAR_INFO toCharInfo(const Cell& cell) {
+        CHAR_INFO ci {};
+        ci.Char.UnicodeChar = cell.ch;
+        ci.Attributes = cell.attr;
+        if (cell.flags & Cell::WideLead) ci.Attributes |= COMMON_LVB_LEADING_BYTE;
+        if (cell.flags & Cell::WideTrail) ci.Attributes |= COMMON_LVB_TRAILING_BYTE;
+        return ci;
+    }
+};
@@ -0,0 +1,42 @@
+#pragma once
+// Счётчик выделений памяти для бенчмарков: глобальные operator new/delete подменяются
+// и считают каждый вызов. Заголовок подключается ровно в одну единицу трансляции программы
+// (определения не inline - так требует стандарт для замены operator new).
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+
+namespace AllocCounter {
+inline std::atomic<size_t> allocations {0};
+inline size_t count() { return allocations.load(std::memory_order_relaxed); }
+
+#ifdef _WIN32
+inline void* alignedAlloc(std::size_t size, std::size_t align) { return _aligned_malloc(size, align); }
+inline void alignedFree(void* p) { _aligned_free(p); }
+#else
+inline void* alignedAlloc(std::size_t size, std::size_t align) { return std::aligned_alloc(align, (size + align - 1) / align * align); }
+inline void alignedFree(void* p) { std::free(p); }
+#endif
+}
+
+void* operator new(std::size_t size) {
+    AllocCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    AllocCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = AllocCounter::alignedAlloc(size ? size : 1, static_cast<std::size_t>(align))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) { return ::operator new(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { AllocCounter::alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AllocCounter::alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { AllocCounter::alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { AllocCounter::alignedFree(p); }
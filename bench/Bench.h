@@ -0,0 +1,144 @@
+#pragma once
+// Общая обвязка бенчмарков: замер кадра на HeadlessBackend и вывод таблицей, JSON или CSV.
+//   bench_xxx            - таблица для человека
+//   bench_xxx --json     - JSON-массив результатов
+//   bench_xxx --csv      - CSV с заголовком
+//   --out=<file>         - писать в файл вместо stdout
+// Подключается в одну единицу трансляции бенчмарка: вместе с ним подменяется operator new (AllocCounter.h).
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "AllocCounter.h"
+
+namespace Bench {
+
+using Stats = HeadlessBackend::Stats;
+
+enum class Format { Table, Json, Csv };
+
+struct Result {
+    std::string name;
+    std::string mode;               // direct | surface
+    size_t iterations {0};
+    double nsPerFrame {0};
+    double cellsPerFrame {0};       // Ячеек, ушедших в бэкенд за кадр
+    double callsPerFrame {0};       // Операций бэкенда (writeRun/fillRun/writeColumn) за кадр
+    double cellsPerSec {0};
+    double allocsPerFrame {0};      // Выделений памяти (operator new) за кадр
+};
+
+struct Options {
+    Format format {Format::Table};
+    std::string out;
+    std::chrono::milliseconds minTime {100};
+};
+
+inline Options parseArgs(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") options.format = Format::Json;
+        else if (arg == "--csv") options.format = Format::Csv;
+        else if (arg.rfind("--out=", 0) == 0) options.out = arg.substr(6);
+        else if (arg.rfind("--min-ms=", 0) == 0) options.minTime = std::chrono::milliseconds(std::stol(arg.substr(9)));
+    }
+    return options;
+}
+
+// Гоняет frame() не меньше minTime (и не меньше 10 раз); числа берутся из счётчиков бэкенда.
+// prepare() вызывается перед каждым кадром и в замер не входит (например, сброс экрана).
+inline Result measure(const std::string& name, const std::string& mode, HeadlessBackend& backend,
+                      const std::function<void()>& frame, std::chrono::milliseconds minTime,
+                      const std::function<void()>& prepare = nullptr) {
+    using clock = std::chrono::steady_clock;
+    if (prepare) prepare();
+    frame(); // Прогрев: аллокации буферов, первый вывод
+    Result r { name, mode };
+    Stats counted;
+    size_t allocations = 0;
+    auto elapsed = clock::duration::zero();
+    while (r.iterations < 10 || elapsed < minTime) {
+        if (prepare) prepare();
+        backend.resetStats();
+        size_t allocated = AllocCounter::count();
+        auto start = clock::now();
+        frame();
+        elapsed += clock::now() - start;
+        allocations += AllocCounter::count() - allocated;
+        counted.cells += backend.stats.cells;
+        counted.runs += backend.stats.runs;
+        r.iterations++;
+    }
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    r.nsPerFrame = ns / r.iterations;
+    r.cellsPerFrame = static_cast<double>(counted.cells) / r.iterations;
+    r.callsPerFrame = static_cast<double>(counted.runs) / r.iterations;
+    r.cellsPerSec = ns > 0 ? counted.cells * 1e9 / ns : 0;
+    r.allocsPerFrame = static_cast<double>(allocations) / r.iterations;
+    return r;
+}
+
+inline std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+inline void write(std::ostream& os, const std::vector<Result>& results, Format format) {
+    os << std::fixed << std::setprecision(1);
+    switch (format) {
+        case Format::Json:
+            os << "[\n";
+            for (size_t i = 0; i < results.size(); ++i) {
+                const Result& r = results[i];
+                os << "  {\"name\": \"" << jsonEscape(r.name) << "\", \"mode\": \"" << r.mode << "\""
+                   << ", \"iterations\": " << r.iterations
+                   << ", \"ns_per_frame\": " << r.nsPerFrame
+                   << ", \"cells_per_frame\": " << r.cellsPerFrame
+                   << ", \"calls_per_frame\": " << r.callsPerFrame
+                   << ", \"cells_per_sec\": " << r.cellsPerSec
+                   << ", \"allocs_per_frame\": " << r.allocsPerFrame << "}"
+                   << (i + 1 < results.size() ? ",\n" : "\n");
+            }
+            os << "]\n";
+            break;
+        case Format::Csv:
+            os << "name,mode,iterations,ns_per_frame,cells_per_frame,calls_per_frame,cells_per_sec,allocs_per_frame\n";
+            for (const Result& r : results) {
+                os << r.name << ',' << r.mode << ',' << r.iterations << ',' << r.nsPerFrame << ','
+                   << r.cellsPerFrame << ',' << r.callsPerFrame << ',' << r.cellsPerSec << ',' << r.allocsPerFrame << '\n';
+            }
+            break;
+        default:
+            os << std::left << std::setw(24) << "name" << std::setw(9) << "mode" << std::right
+               << std::setw(12) << "ns/frame" << std::setw(12) << "cells/frame" << std::setw(12) << "calls/frame"
+               << std::setw(14) << "Mcells/s" << std::setw(13) << "allocs/frame" << '\n';
+            for (const Result& r : results) {
+                os << std::left << std::setw(24) << r.name << std::setw(9) << r.mode << std::right
+                   << std::setw(12) << r.nsPerFrame << std::setw(12) << r.cellsPerFrame << std::setw(12) << r.callsPerFrame
+                   << std::setw(14) << r.cellsPerSec / 1e6 << std::setw(13) << r.allocsPerFrame << '\n';
+            }
+            break;
+    }
+}
+
+inline void report(const std::vector<Result>& results, const Options& options) {
+    if (options.out.empty()) {
+        write(std::cout, results, options.format);
+        return;
+    }
+    std::ofstream file(options.out);
+    write(file, results, options.format);
+}
+
+} // namespace Bench
@@ -0,0 +1,202 @@
+#pragma once
+// Экраны демо-программ (src/demo1..5) без main() и WinAPI-диалогов - для бенчмарков.
+// Каждый экран - набор корневых элементов и сценарий ввода, который разыгрывается по кадру на событие.
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "Platform.h"
+#include "Render.h"
+#include "EventManager.h"
+#include "FocusManager.h"
+#include "FrameScheduler.h"
+#include "../BasicElements/Container.h"
+#include "../BasicElements/ScrollContainer.h"
+#include "../BasicElements/GridContainer.h"
+#include "../BasicElements/FlexContainer.h"
+#include "../BasicElements/VirtualScrollContainer.h"
+#include "../BasicElements/Label.h"
+#include "../BasicElements/FiButton.h"
+#include "../BasicElements/CFButton.h"
+#include "../BasicElements/TextBox.h"
+#include "../BasicElements/CheckBox.h"
+
+inline void CFButton::action() { }
+
+namespace DemoScreens {
+
+// Ячейка-символ из demo4
+class CharacterElement : public Control, public Render {
+public:
+    wchar_t character;
+    CharacterElement(SMALL_RECT r, wchar_t c) : Control(r), character(c) {}
+    void draw() override {
+        const Cell cells[] = {
+            { L'[', FOREGROUND_GREEN | FOREGROUND_RED },
+            { character, FOREGROUND_RED },
+            { L']', FOREGROUND_GREEN | FOREGROUND_RED },
+        };
+        Render::drawCells({ rect.Left, rect.Top }, cells, 3);
+    }
+};
+
+// Кнопка-символ из demo5
+class ScrollCharacter : public CFButton {
+public:
+    wchar_t character;
+    ScrollCharacter(SMALL_RECT r, wchar_t c) : CFButton(r, std::wstring(1, c)), character(c) {}
+    void draw() override {
+        CFButton::draw();
+        Render::DrawBox(rect);
+        const Cell cells[] = {
+            { L'[', FOREGROUND_GREEN | FOREGROUND_RED },
+            { character, FOREGROUND_RED },
+            { L']', FOREGROUND_GREEN | FOREGROUND_RED },
+        };
+        Render::drawCells({ rect.Left, rect.Top }, cells, 3);
+    }
+};
+
+// Строка файла из demo3 (без ShellExecute и файловой системы)
+class FileEntry : public Control, public Render {
+public:
+    std::wstring name;
+    FileEntry(SMALL_RECT r, const std::wstring& n) : Control(r), name(n) {
+        MouseRouter::add(this);
+    }
+    void draw() override {
+        if (focused)      Render::attr = BACKGROUND_GREEN | FOREGROUND_RED   | FOREGROUND_BLUE  | FOREGROUND_INTENSITY;
+        else if (hovered) Render::attr = BACKGROUND_BLUE  | FOREGROUND_RED   | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+        else              Render::attr = FOREGROUND_RED   | FOREGROUND_GREEN | FOREGROUND_BLUE;
+        Render::fillBox(rect);
+        Render::DrawBox(rect);
+        Render::drawTextLeft(name, rect);
+    }
+};
+
+struct Screen {
+    std::string name;
+    std::vector<std::shared_ptr<Control>> roots;
+    std::vector<INPUT_RECORD> script;   // Типичный ввод пользователя на этом экране
+
+    void draw() {
+        Render::Frame frame;
+        for (auto& root : roots) root->draw();
+    }
+};
+
+inline INPUT_RECORD mouseMove(SHORT x, SHORT y) {
+    INPUT_RECORD record {};
+    record.EventType = MOUSE_EVENT;
+    record.Event.MouseEvent.dwMousePosition = { x, y };
+    record.Event.MouseEvent.dwEventFlags = MOUSE_MOVED;
+    return record;
+}
+
+inline INPUT_RECORD mouseWheel(SHORT x, SHORT y, short delta) {
+    INPUT_RECORD record = mouseMove(x, y);
+    record.Event.MouseEvent.dwEventFlags = MOUSE_WHEELED;
+    record.Event.MouseEvent.dwButtonState = static_cast<DWORD>(static_cast<WORD>(delta)) << 16;
+    return record;
+}
+
+inline INPUT_RECORD keyPress(WORD vk, wchar_t ch) {
+    INPUT_RECORD record {};
+    record.EventType = KEY_EVENT;
+    record.Event.KeyEvent.bKeyDown = TRUE;
+    record.Event.KeyEvent.wVirtualKeyCode = vk;
+    record.Event.KeyEvent.uChar.UnicodeChar = ch;
+    record.Event.KeyEvent.wRepeatCount = 1;
+    return record;
+}
+
+// demo1: форма входа, мышь ходит по полям и кнопке
+inline Screen login() {
+    Screen s { "login", {}, {} };
+    s.roots.push_back(std::make_shared<TextBox>(SMALL_RECT{ 10, 4, 50, 6 }, L"Login"));
+    s.roots.push_back(std::make_shared<TextBox>(SMALL_RECT{ 10, 8, 50, 10 }, L"Password"));
+    s.roots.push_back(std::make_shared<CheckBox>(SMALL_RECT{ 10, 12, 50, 14 }, L"Remember Me"));
+    s.roots.push_back(std::make_shared<FIButton>(SMALL_RECT{ 20, 16, 40, 18 }, L"Login"));
+    for (SHORT y : { 5, 9, 13, 17, 2 }) s.script.push_back(mouseMove(30, y));
+    return s;
+}
+
+// demo2: калькулятор, мышь проходит по ряду кнопок
+inline Screen calculator() {
+    Screen s { "calculator", {}, {} };
+    const wchar_t* layout = L"789/456*123-0.=+";
+    auto keys = std::make_shared<GridContainer>(SMALL_RECT{ 10, 6, 53, 17 }, std::vector<GridTrack>(4, GridTrack::star()), std::vector<GridTrack>(4, GridTrack::star()));
+    keys->bordered = false;
+    for (SHORT i = 0; i < 16; ++i) keys->addControl(std::make_shared<FIButton>(SMALL_RECT{ 0, 0, 10, 2 }, layout[i]));
+    keys->rearrangeControls();
+    s.roots.push_back(keys);
+    s.roots.push_back(std::make_shared<Label>(SMALL_RECT{ 10, 2, 53, 4 }, L"0"));
+    for (SHORT x = 15; x < 54; x += 11) s.script.push_back(mouseMove(x, 7));
+    for (SHORT y = 10; y < 18; y += 3) s.script.push_back(mouseMove(48, y));
+    return s;
+}
+
+// demo3: страница проводника - список файлов и панель справа
+inline Screen explorer() {
+    Screen s { "explorer", {}, {} };
+    auto files = std::make_shared<VirtualScrollContainer>(SMALL_RECT{ 5, 2, 50, 37 }, 2,
+        [] { return std::make_shared<FileEntry>(SMALL_RECT{ 5, 0, 50, 2 }, L""); },
+        [](Control& row, size_t index) { static_cast<FileEntry&>(row).name = L"file_" + std::to_wstring(index) + L".txt"; });
+    files->bordered = false;
+    files->setItemCount(11);
+    s.roots.push_back(files);
+    s.roots.push_back(std::make_shared<Label>(SMALL_RECT{ 60, 2, 110, 5 }, L"C:\\Users\\demo\\Documents"));
+    s.roots.push_back(std::make_shared<Label>(SMALL_RECT{ 60, 7, 110, 10 }, L"[Press ESC to exit...]", 3));
+    s.roots.push_back(std::make_shared<Label>(SMALL_RECT{ 60, 10, 110, 13 }, L"0 / 1", 3));
+    s.roots.push_back(std::make_shared<Label>(SMALL_RECT{ 60, 13, 110, 15 }, L"[Use F9/F10 to change page]", 2));
+    for (SHORT y = 3; y < 35; y += 3) s.script.push_back(mouseMove(20, y));
+    return s;
+}
+
+// demo4: сетка символов в контейнерах
+inline Screen grid() {
+    Screen s { "grid", {}, {} };
+    auto root = std::make_shared<Container>(SMALL_RECT{ 5, 5, 45, 25 }, Container::Vertical);
+    root->bordered = true;
+    root->padding = { 1, 1, 1, 1 };
+    for (int r = 0, chari = 0; r < 5; ++r) {
+        std::vector<std::shared_ptr<Control>> elems;
+        for (int c = 0; c < 6; ++c) elems.push_back(std::make_shared<CharacterElement>(SMALL_RECT{ 0, 0, 3, 2 }, static_cast<wchar_t>(L'A' + chari++)));
+        auto row = std::make_shared<Container>(SMALL_RECT{ 0, 0, 18, 2 }, Container::Horizontal, elems);
+        row->alignment = Container::Center;
+        row->padding.Top = 1;
+        root->addControl(row);
+        root->rearrangeControls();
+        row->rearrangeControls();
+    }
+    s.roots.push_back(root);
+    return s; // Обработчиков ввода нет: сценарий пуст, меряется только полный кадр
+}
+
+// demo5: прокручиваемый список кнопок, колесо вниз и обратно
+inline Screen scroll() {
+    Screen s { "scroll", {}, {} };
+    auto root = std::make_shared<ScrollContainer>(SMALL_RECT{ 5, 5, 45, 25 }, Container::Vertical);
+    root->padding = { 1, 1, 1, 1 };
+    root->spacing = 1;
+    root->addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 1 }, L"--- WTF UI Scroll Test ---", 0));
+    for (int i = 0; i < 20; i++) root->addControl(std::make_shared<ScrollCharacter>(SMALL_RECT{ 0, 0, 3, 3 }, static_cast<wchar_t>(L'A' + (i % 26))));
+    root->rearrangeControls();
+    s.roots.push_back(root);
+    for (int i = 0; i < 4; ++i) s.script.push_back(mouseWheel(20, 15, -WHEEL_DELTA));
+    for (int i = 0; i < 4; ++i) s.script.push_back(mouseWheel(20, 15, WHEEL_DELTA));
+    return s;
+}
+
+inline std::vector<std::function<Screen()>> all() {
+    return { login, calculator, explorer, grid, scroll };
+}
+
+// Экран держит raw-указатели в обработчиках EventManager и MouseRouter: перед его уничтожением их надо снять
+inline void release() {
+    EventManager::getInstance().clearAllHandlers();
+    MouseRouter::clear();
+    FocusManager::clearControls();
+}
+
+} // namespace DemoScreens
@@ -0,0 +1,113 @@
+// Байты на кадр для VT-вывода экранов демо: наивное кодирование (CUP на отрезок, полный SGR
+// при каждой смене атрибута) против AnsiEncoder, с REP и без. Вывод никуда не пишется, только считается.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "Platform.h"
+#include "Render.h"
+#include "VtBackend.h"
+#include "DemoScreens.h"
+
+// То, что делал VtBackend до AnsiEncoder: каждый отрезок сам по себе
+class NaiveVtBackend : public RenderBackend {
+public:
+    size_t frameBytes {0};
+    size_t bytes {0};
+    COORD screenSize;
+
+    explicit NaiveVtBackend(COORD s) : screenSize(s) {}
+
+    COORD size() override { return screenSize; }
+
+    void writeRun(COORD pos, const Cell* cells, SHORT length) override {
+        if (length <= 0) return;
+        appendCup(pos);
+        WORD current = cells[0].attr;
+        appendSgr(current);
+        for (SHORT i = 0; i < length; ++i) {
+            if (cells[i].attr != current) appendSgr(current = cells[i].attr);
+            AnsiEncoder::appendUtf8(out, cells[i].ch);
+        }
+    }
+
+    void clear(WORD attr) override {
+        appendSgr(attr);
+        out += "\x1b[2J";
+    }
+
+    void resize(COORD s) override { screenSize = s; }
+    void setCursor(COORD pos) override { appendCup(pos); }
+
+    void flush() override {
+        frameBytes = out.size();
+        bytes += out.size();
+        out.clear();
+    }
+
+private:
+    std::string out;
+
+    void appendCup(COORD pos) { out += "\x1b[" + std::to_string(pos.Y + 1) + ";" + std::to_string(pos.X + 1) + "H"; }
+    void appendSgr(WORD attr) {
+        out += "\x1b[" + std::to_string(AnsiEncoder::ansiForeground(attr)) + ";" + std::to_string(AnsiEncoder::ansiBackground(attr)) + "m";
+    }
+};
+
+struct Result {
+    std::string screen;
+    size_t fullFrame {0};
+    double perEvent {0};
+};
+
+// Полный кадр экрана, затем по кадру на каждое событие сценария
+template <typename Backend, typename FrameBytes>
+Result measure(const std::function<DemoScreens::Screen()>& make, Backend& backend, FrameBytes frameBytes) {
+    Render::setBackend(&backend);
+    Render::enableBackBuffer();
+    Result result;
+    {
+        DemoScreens::Screen screen = make();
+        result.screen = screen.name;
+        screen.draw();
+        result.fullFrame = frameBytes();
+        size_t total = 0;
+        for (const INPUT_RECORD& record : screen.script) {
+            {
+                Render::Frame frame;
+                EventManager::getInstance().dispatch(record);
+                FrameScheduler::drain();
+            }
+            total += frameBytes();
+        }
+        if (!screen.script.empty()) result.perEvent = static_cast<double>(total) / screen.script.size();
+        DemoScreens::release();
+    }
+    Render::disableBackBuffer();
+    return result;
+}
+
+int main() {
+    const COORD size { 120, 40 };
+    std::cout << std::left << std::setw(12) << "screen"
+              << std::right << std::setw(14) << "naive full" << std::setw(14) << "ansi full"
+              << std::setw(14) << "ansi+rep full"
+              << std::setw(14) << "naive/event" << std::setw(14) << "ansi/event" << std::setw(14) << "ansi+rep/ev" << std::endl;
+
+    for (const auto& make : DemoScreens::all()) {
+        NaiveVtBackend naive(size);
+        Result n = measure(make, naive, [&] { return naive.frameBytes; });
+
+        VtBackend vt(-1, size);
+        Result a = measure(make, vt, [&] { return vt.stats.lastFrameBytes; });
+
+        VtBackend vtRep(-1, size);
+        vtRep.getEncoder().useRepeat = true;
+        Result r = measure(make, vtRep, [&] { return vtRep.stats.lastFrameBytes; });
+
+        std::cout << std::left << std::setw(12) << n.screen
+                  << std::right << std::setw(14) << n.fullFrame << std::setw(14) << a.fullFrame << std::setw(14) << r.fullFrame
+                  << std::setw(14) << std::fixed << std::setprecision(1) << n.perEvent
+                  << std::setw(14) << a.perEvent << std::setw(14) << r.perEvent << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Смена одной подписи в глубокой раскладке: дерево контейнеров, делящих экран пополам
+// (по очереди по горизонтали и вертикали), в листьях - Label. На каждой глубине два случая:
+//   tree  - перерисовка всего дерева от корня (как Container::draw / FocusManager::redrawAll);
+//   label - у одной подписи меняется текст, она вызывает invalidate(), повреждение поднимается
+//           к корню и кадр спускается только в поддеревья, задевающие подпись.
+// visits - вызовы paint() за кадр: для label это путь от корня до подписи, а не всё дерево.
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "FrameScheduler.h"
+#include "../BasicElements/Container.h"
+#include "../BasicElements/Label.h"
+
+static std::shared_ptr<Control> build(SMALL_RECT r, int depth, bool horizontal, std::vector<Label*>& labels) {
+    if (depth == 0) {
+        auto label = std::make_shared<Label>(r, L"item " + std::to_wstring(labels.size()));
+        labels.push_back(label.get());
+        return label;
+    }
+    auto box = std::make_shared<Container>(r, horizontal ? Container::Horizontal : Container::Vertical);
+    box->bordered = false;
+    SMALL_RECT first = r, second = r;
+    if (horizontal) {
+        first.Right = static_cast<SHORT>(r.Left + (r.Right - r.Left) / 2);
+        second.Left = static_cast<SHORT>(first.Right + 1);
+    } else {
+        first.Bottom = static_cast<SHORT>(r.Top + (r.Bottom - r.Top) / 2);
+        second.Top = static_cast<SHORT>(first.Bottom + 1);
+    }
+    box->addControl(build(first, depth - 1, !horizontal, labels));
+    box->addControl(build(second, depth - 1, !horizontal, labels));
+    return box;
+}
+
+struct Result {
+    double usPerFrame {0};
+    double visitsPerFrame {0};
+    double cellsPerFrame {0};
+};
+
+template <typename F>
+static Result measure(F&& change) {
+    const int frames = 2000;
+    FrameScheduler::resetStats();
+    Render::stats = {};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        change(i);
+        FrameScheduler::drain();
+    }
+    Result r;
+    r.usPerFrame = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+    r.visitsPerFrame = static_cast<double>(FrameScheduler::stats.visits) / frames;
+    r.cellsPerFrame = static_cast<double>(Render::stats.cellsPresented) / frames;
+    return r;
+}
+
+int main() {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    std::cout << std::left << std::setw(8) << "depth" << std::right << std::setw(8) << "labels" << std::setw(9) << "nodes"
+              << std::setw(8) << "case" << std::setw(12) << "us/frame" << std::setw(10) << "visits" << std::setw(10) << "cells" << std::endl;
+    for (int depth : { 2, 4, 6, 8 }) {
+        std::vector<Label*> labels;
+        std::shared_ptr<Control> root = build({ 0, 0, 119, 39 }, depth, true, labels);
+        root->draw();
+        Label* target = labels[labels.size() / 2 + 1];
+
+        Result tree = measure([&](int i) {
+            target->text = (i % 2) ? L"changed" : L"item";
+            root->invalidate();
+        });
+        Result label = measure([&](int i) {
+            target->text = (i % 2) ? L"changed" : L"item";
+            target->invalidate();
+        });
+
+        size_t nodes = 2 * labels.size() - 1;
+        for (auto [name, r] : { std::pair{ "tree", tree }, std::pair{ "label", label } }) {
+            std::cout << std::left << std::setw(8) << depth << std::right << std::setw(8) << labels.size() << std::setw(9) << nodes
+                      << std::setw(8) << name << std::fixed << std::setprecision(2) << std::setw(12) << r.usPerFrame
+                      << std::setprecision(1) << std::setw(10) << r.visitsPerFrame << std::setw(10) << r.cellsPerFrame << std::endl;
+        }
+    }
+
+    Render::disableBackBuffer();
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Пропускная способность поиска изменённых отрезков (CellDiff::forEachRun) для каждого ядра:
+// полный кадр (изменено всё), разреженные изменения (~1% ячеек) и кадр без изменений.
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "Platform.h"
+#include "Cell.h"
+#include "CellDiff.h"
+#include "AlignedAllocator.h"
+
+using Buffer = std::vector<Cell, AlignedAllocator<Cell>>;
+
+struct Scenario {
+    const char* name;
+    Buffer back;
+    Buffer front;
+};
+
+// Возвращает число отрезков (чтобы компилятор не выбросил цикл) и время на кадр
+std::pair<size_t, double> measure(const Scenario& s, COORD size, int frames) {
+    size_t runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (SHORT y = 0; y < size.Y; ++y) {
+            const size_t row = static_cast<size_t>(y) * size.X;
+            CellDiff::forEachRun(s.back.data() + row, s.front.data() + row, size.X, 4, [&](size_t, size_t) { ++runs; });
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return { runs / frames, ns / frames };
+}
+
+int main() {
+    const int frames = 2000;
+    std::mt19937 rng(42);
+
+    for (COORD size : { COORD{ 200, 60 }, COORD{ 400, 120 } }) {
+        const size_t count = static_cast<size_t>(size.X) * size.Y;
+        Buffer base(count);
+        for (size_t i = 0; i < count; ++i) base[i] = { static_cast<wchar_t>(L'a' + i % 26), static_cast<WORD>(i % 16) };
+
+        std::vector<Scenario> scenarios;
+        scenarios.push_back({ "full", base, base });
+        for (Cell& c : scenarios.back().back) c.attr ^= BACKGROUND_BLUE;
+        scenarios.push_back({ "sparse", base, base });
+        for (size_t i = 0; i < count / 100; ++i) scenarios.back().back[rng() % count].ch = L'#';
+        scenarios.push_back({ "none", base, base });
+
+        std::cout << size.X << "x" << size.Y << " (" << count << " cells)" << std::endl;
+        std::cout << std::left << std::setw(10) << "frame" << std::setw(8) << "kernel"
+                  << std::right << std::setw(10) << "runs" << std::setw(12) << "us/frame" << std::setw(14) << "Gcells/s" << std::endl;
+        for (const Scenario& s : scenarios) {
+            for (CellDiff::Kernel k : { CellDiff::Kernel::Scalar, CellDiff::Kernel::SSE2, CellDiff::Kernel::AVX2 }) {
+                if (!CellDiff::supported(k)) continue;
+                CellDiff::kernel = k;
+                auto [runs, ns] = measure(s, size, frames);
+                std::cout << std::left << std::setw(10) << s.name << std::setw(8) << CellDiff::name(k)
+                          << std::right << std::setw(10) << runs
+                          << std::setw(12) << std::fixed << std::setprecision(2) << ns / 1000
+                          << std::setw(14) << std::setprecision(2) << count / ns << std::endl;
+            }
+        }
+        std::cout << std::endl;
+    }
+    CellDiff::kernel = CellDiff::best();
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Цена раздачи одного события в зависимости от числа обработчиков:
+// copy/mutex        - самый первый HandlerContainer: копия вектора shared_ptr под std::mutex на каждое событие;
+// copy/shared_mutex - прежний HandlerContainerShared: то же под shared_lock;
+// rcu/shared_ptr    - снимок из shared_ptr<std::function>, новая версия на каждую подписку;
+// slots             - текущий HandlerContainer: делегаты с буфером на месте, слоты с поколениями.
+// В demo3 у каждой FileButton свой обработчик мыши, так что каждое движение мыши платит за всех.
+// Вторая таблица - смена фокуса TextBox: отписка, подписка и одно событие клавиатуры.
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include "Platform.h"
+#include "HandlerContainer.h"
+#include "AllocCounter.h"
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T>
+using HandlerPtr = std::shared_ptr<std::function<void(const T&)>>;
+
+// Прежние контейнеры - только чтобы было с чем сравнивать
+template <typename T, typename Mutex>
+class CopyingContainer {
+    std::vector<HandlerPtr<T>> handlers;
+    mutable Mutex mutex;
+
+public:
+    HandlerPtr<T> addHandler(std::function<void(const T&)> handler) {
+        std::unique_lock lock(mutex);
+        auto handlerPtr = std::make_shared<std::function<void(const T&)>>(handler);
+        handlers.push_back(handlerPtr);
+        return handlerPtr;
+    }
+
+    bool removeHandler(const HandlerPtr<T>& handlerPtr) {
+        std::unique_lock lock(mutex);
+        auto it = std::find(handlers.begin(), handlers.end(), handlerPtr);
+        if (it == handlers.end()) return false;
+        handlers.erase(it);
+        return true;
+    }
+
+    void invokeHandlers(const T& event) const {
+        std::vector<HandlerPtr<T>> handlersCopy;
+        {
+            std::unique_lock lock(mutex);
+            handlersCopy = handlers;
+        }
+        for (const auto& handler : handlersCopy) (*handler)(event);
+    }
+};
+
+template <typename T>
+class SharedPtrSnapshotContainer {
+    using List = std::vector<HandlerPtr<T>>;
+    std::atomic<std::shared_ptr<const List>> handlers {std::make_shared<const List>()};
+    std::mutex mutex;
+
+    template <typename Edit>
+    bool publish(Edit&& edit) {
+        std::lock_guard lock(mutex);
+        auto next = std::make_shared<List>(*handlers.load(std::memory_order_acquire));
+        if (!edit(*next)) return false;
+        handlers.store(std::move(next), std::memory_order_release);
+        return true;
+    }
+
+public:
+    HandlerPtr<T> addHandler(std::function<void(const T&)> handler) {
+        auto handlerPtr = std::make_shared<std::function<void(const T&)>>(std::move(handler));
+        publish([&](List& list) { list.push_back(handlerPtr); return true; });
+        return handlerPtr;
+    }
+
+    bool removeHandler(const HandlerPtr<T>& handlerPtr) {
+        return publish([&](List& list) {
+            auto it = std::find(list.begin(), list.end(), handlerPtr);
+            if (it == list.end()) return false;
+            list.erase(it);
+            return true;
+        });
+    }
+
+    void invokeHandlers(const T& event) const {
+        auto current = handlers.load(std::memory_order_acquire);
+        for (const auto& handler : *current) (*handler)(event);
+    }
+};
+
+template <typename Container>
+void run(const char* name, size_t handlers) {
+    Container container;
+    long long sink = 0;
+    for (size_t i = 0; i < handlers; ++i) {
+        container.addHandler([&sink](const MOUSE_EVENT_RECORD& mer) { sink += mer.dwMousePosition.X; });
+    }
+
+    MOUSE_EVENT_RECORD mer {};
+    mer.dwEventFlags = MOUSE_MOVED;
+    const size_t events = (std::max)(size_t(2000), size_t(2'000'000) / handlers);
+    container.invokeHandlers(mer); // Прогрев
+
+    size_t allocated = AllocCounter::count();
+    auto start = Clock::now();
+    for (size_t i = 0; i < events; ++i) {
+        mer.dwMousePosition.X = static_cast<SHORT>(i & 0x7f);
+        container.invokeHandlers(mer);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    double allocs = static_cast<double>(AllocCounter::count() - allocated) / events;
+
+    std::cout << std::left << std::setw(20) << name << std::right << std::setw(10) << handlers
+              << std::fixed << std::setprecision(1) << std::setw(14) << ns / events
+              << std::setw(18) << ns / events / handlers << std::setw(14) << allocs << std::endl;
+}
+
+// Смена фокуса: обработчик клавиатуры старого TextBox снимается, нового - ставится, приходит клавиша
+template <typename Container>
+void churn(const char* name, size_t handlers) {
+    Container container;
+    long long sink = 0;
+    for (size_t i = 0; i < handlers; ++i) {
+        container.addHandler([&sink](const KEY_EVENT_RECORD& ker) { sink += ker.wVirtualKeyCode; });
+    }
+
+    struct Box { long long typed {0}; } boxes[2];
+    KEY_EVENT_RECORD ker {};
+    ker.bKeyDown = TRUE;
+    auto subscribe = [&](Box& box) {
+        return container.addHandler([&box](const KEY_EVENT_RECORD& k) { box.typed += k.wVirtualKeyCode; });
+    };
+    auto current = subscribe(boxes[0]);
+    container.invokeHandlers(ker); // Прогрев
+
+    const size_t rounds = (std::max)(size_t(2000), size_t(2'000'000) / handlers);
+    size_t allocated = AllocCounter::count();
+    auto start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) {
+        container.removeHandler(current);
+        current = subscribe(boxes[(i + 1) & 1]);
+        ker.wVirtualKeyCode = static_cast<WORD>(i & 0x7f);
+        container.invokeHandlers(ker);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    double allocs = static_cast<double>(AllocCounter::count() - allocated) / rounds;
+
+    std::cout << std::left << std::setw(20) << name << std::right << std::setw(10) << handlers
+              << std::fixed << std::setprecision(1) << std::setw(14) << ns / rounds << std::setw(16) << allocs << std::endl;
+}
+
+int main() {
+    std::cout << std::left << std::setw(20) << "container" << std::right << std::setw(10) << "handlers"
+              << std::setw(14) << "ns/event" << std::setw(18) << "ns/handler call" << std::setw(14) << "allocs/event" << std::endl;
+    for (size_t handlers : { size_t(1), size_t(8), size_t(64), size_t(512) }) {
+        run<CopyingContainer<MOUSE_EVENT_RECORD, std::mutex>>("copy/mutex", handlers);
+        run<CopyingContainer<MOUSE_EVENT_RECORD, std::shared_mutex>>("copy/shared_mutex", handlers);
+        run<SharedPtrSnapshotContainer<MOUSE_EVENT_RECORD>>("rcu/shared_ptr", handlers);
+        run<HandlerContainer<MOUSE_EVENT_RECORD>>("slots", handlers);
+    }
+
+    std::cout << std::endl << std::left << std::setw(20) << "container" << std::right << std::setw(10) << "handlers"
+              << std::setw(14) << "ns/refocus" << std::setw(16) << "allocs/refocus" << std::endl;
+    for (size_t handlers : { size_t(1), size_t(8), size_t(64), size_t(512) }) {
+        churn<CopyingContainer<KEY_EVENT_RECORD, std::mutex>>("copy/mutex", handlers);
+        churn<SharedPtrSnapshotContainer<KEY_EVENT_RECORD>>("rcu/shared_ptr", handlers);
+        churn<HandlerContainer<KEY_EVENT_RECORD>>("slots", handlers);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Панель из N клеток при смене размера окна (WINDOW_BUFFER_SIZE_EVENT): корень меняет rect,
+// все клетки встают заново. На каждом N два контейнера:
+//   grid - GridContainer, квадратная сетка: столбец заголовков Auto, остальные Star, строки Fixed;
+//   flex - FlexContainer с переносом: подписи разной ширины, каждая третья растёт.
+// Ширина окна ходит между 80 и 160 столбцами. us/resize - одна перераскладка (setRect корня),
+// ns/cell - она же на клетку: решение линейно, при росте N в 64 раза ns/cell почти не меняется.
+// moved - клетки, сменившие rect за одну смену размера; lines - строки переноса у flex.
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <tuple>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "FrameScheduler.h"
+#include "../BasicElements/GridContainer.h"
+#include "../BasicElements/FlexContainer.h"
+#include "../BasicElements/Label.h"
+
+struct Result {
+    double usPerResize {0};
+    double nsPerCell {0};
+    size_t moved {0};
+};
+
+static size_t countMoved(const std::vector<SMALL_RECT>& before, const Container& box) {
+    size_t moved = 0;
+    for (size_t i = 0; i < before.size(); ++i) {
+        const SMALL_RECT& a = before[i];
+        const SMALL_RECT& b = box.controls[i]->rect;
+        moved += a.Top != b.Top || a.Bottom != b.Bottom || a.Left != b.Left || a.Right != b.Right;
+    }
+    return moved;
+}
+
+static Result resize(Container& box, size_t cells) {
+    const int rounds = 200;
+    std::vector<SMALL_RECT> before;
+    for (auto& ctrl : box.controls) before.push_back(ctrl->rect);
+
+    Result r;
+    std::chrono::nanoseconds total {0};
+    for (int i = 0; i < rounds; ++i) {
+        SHORT width = static_cast<SHORT>(80 + (i * 37) % 81);
+        auto start = std::chrono::steady_clock::now();
+        box.setRect({ 0, 0, static_cast<SHORT>(width - 1), box.rect.Bottom });
+        FrameScheduler::layout();
+        total += std::chrono::steady_clock::now() - start;
+        if (i == 0) r.moved = countMoved(before, box);
+    }
+    double ns = static_cast<double>(total.count()) / rounds;
+    r.usPerResize = ns / 1000;
+    r.nsPerCell = ns / static_cast<double>(cells);
+    return r;
+}
+
+int main() {
+    HeadlessBackend screen({ 160, 50 });
+    Render::setBackend(&screen);
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    std::cout << std::left << std::setw(8) << "cells" << std::setw(7) << "layout" << std::right << std::setw(13) << "us/resize"
+              << std::setw(11) << "ns/cell" << std::setw(9) << "moved" << std::setw(8) << "lines" << std::endl;
+    for (size_t cells : { 100, 400, 1600, 6400 }) {
+        const size_t side = static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(cells))));
+
+        std::vector<GridTrack> columns(side, GridTrack::star());
+        columns[0] = GridTrack::autoSize();
+        GridContainer grid({ 0, 0, 119, 49 }, std::vector<GridTrack>(side, GridTrack::fixed(1)), columns);
+        grid.bordered = false;
+        for (size_t i = 0; i < cells; ++i) {
+            std::wstring text = i % side == 0 ? L"row " + std::to_wstring(i / side) : std::to_wstring(i);
+            grid.addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, static_cast<SHORT>(text.size()), 1 }, text, 0));
+        }
+        grid.rearrangeControls();
+
+        FlexContainer flex({ 0, 0, 119, 49 }, Container::Horizontal);
+        flex.bordered = false;
+        flex.wrap = true;
+        for (size_t i = 0; i < cells; ++i) {
+            SHORT width = static_cast<SHORT>(4 + i % 7);
+            flex.addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, width, 1 }, std::to_wstring(i), 0), FlexItem{ static_cast<short>(i % 3 == 0), 1 });
+        }
+        flex.rearrangeControls();
+
+        Result g = resize(grid, cells);
+        Result f = resize(flex, cells);
+        size_t lines = 1;
+        for (size_t i = 1; i < flex.controls.size(); ++i) lines += flex.controls[i]->rect.Top != flex.controls[i - 1]->rect.Top;
+
+        for (auto [name, r, rows] : { std::tuple{ "grid", g, side }, std::tuple{ "flex", f, lines } }) {
+            std::cout << std::left << std::setw(8) << cells << std::setw(7) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(13) << r.usPerResize << std::setprecision(1) << std::setw(11) << r.nsPerCell
+                      << std::setw(9) << r.moved << std::setw(8) << rows << std::endl;
+        }
+    }
+
+    Render::setBackend(nullptr);
+    return 0;
+}
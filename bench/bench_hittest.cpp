@@ -0,0 +1,68 @@
+// Движение мыши по сетке из N элементов:
+// broadcast - как раньше: у каждого элемента свой обработчик мыши, событие получают все;
+// router    - MouseRouter: событие получают элементы под курсором и тот, с которого курсор ушёл.
+// onMouse/event - сколько элементов вызвано на одно событие.
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include "Platform.h"
+#include "Control.h"
+#include "HandlerContainer.h"
+#include "MouseRouter.h"
+#include "FrameScheduler.h"
+
+using Clock = std::chrono::steady_clock;
+
+class Probe : public Control {
+public:
+    inline static size_t calls {0};
+    using Control::Control;
+    void draw() override {}
+    void onMouse(const MOUSE_EVENT_RECORD& mer) override {
+        calls++;
+        Control::onMouse(mer);
+    }
+};
+
+static void run(const char* name, size_t count, bool routed) {
+    const SHORT perRow = 50;    // Элементы 4x2, по 50 в строке
+    std::vector<std::unique_ptr<Probe>> probes;
+    HandlerContainer<MOUSE_EVENT_RECORD> broadcast;
+    for (size_t i = 0; i < count; ++i) {
+        SHORT x = static_cast<SHORT>((i % perRow) * 5), y = static_cast<SHORT>((i / perRow) * 3);
+        probes.push_back(std::make_unique<Probe>(SMALL_RECT{ x, y, static_cast<SHORT>(x + 3), static_cast<SHORT>(y + 1) }));
+        Probe* probe = probes.back().get();
+        if (routed) MouseRouter::add(probe);
+        else broadcast.addHandler([probe](const MOUSE_EVENT_RECORD& mer) { probe->onMouse(mer); });
+    }
+
+    const SHORT width = perRow * 5, height = static_cast<SHORT>((count + perRow - 1) / perRow * 3);
+    MOUSE_EVENT_RECORD mer {};
+    mer.dwEventFlags = MOUSE_MOVED;
+    const size_t events = (std::max)(size_t(2000), size_t(20'000'000) / count);
+    Probe::calls = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < events; ++i) {
+        mer.dwMousePosition = { static_cast<SHORT>((i * 7) % width), static_cast<SHORT>((i * 3 / width) % height) };
+        if (routed) MouseRouter::route(mer);
+        else broadcast.invokeHandlers(mer);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << std::left << std::setw(11) << name << std::right << std::setw(10) << count
+              << std::fixed << std::setprecision(1) << std::setw(14) << ns / events
+              << std::setw(16) << static_cast<double>(Probe::calls) / events << std::endl;
+    MouseRouter::clear();
+}
+
+int main() {
+    FrameScheduler::mode = FrameScheduler::Immediate; // draw() пустой, очередь кадров не нужна
+    std::cout << std::left << std::setw(11) << "mode" << std::right << std::setw(10) << "controls"
+              << std::setw(14) << "ns/event" << std::setw(16) << "onMouse/event" << std::endl;
+    for (size_t count : { size_t(10), size_t(100), size_t(1000), size_t(10000) }) {
+        run("broadcast", count, false);
+        run("router", count, true);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Задержка клавиатуры под потоком движений мыши (InputLanes).
+// Экран входа (demo1), фокус в поле ввода. Источник шлёт пачки по 64 записи раз в миллисекунду:
+// 63 движения мыши по полям и одно нажатие клавиши. Движения не сливаются в пачке (move = Keep) -
+// как над множеством элементов с подсветкой; work - сколько микросекунд обработчик тратит на движение.
+// ordered - всё подряд в порядке поступления (prioritize = false), lanes - полосы с бюджетами.
+// key dispatch - от чтения клавиши до её обработчика; paint - от чтения до кадра на экране по любому вводу
+// (поле ввода помнит самую раннюю запись, из-за которой перерисовывается, - часто это наведение мыши).
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "EventManager.h"
+#include "InputSource.h"
+#include "LatencyTracker.h"
+#include "DemoScreens.h"
+
+using Clock = std::chrono::steady_clock;
+
+static void spin(std::chrono::microseconds work) {
+    auto until = Clock::now() + work;
+    while (Clock::now() < until) {}
+}
+
+static const LatencyRow* find(const std::vector<LatencyRow>& rows, const char* name) {
+    for (const LatencyRow& row : rows) {
+        if (row.name == name) return &row;
+    }
+    return nullptr;
+}
+
+static double ms(std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1e6; }
+
+// Худшая строка таблицы
+static std::chrono::nanoseconds worst(const std::vector<LatencyRow>& rows, std::chrono::nanoseconds LatencyRow::* field) {
+    std::chrono::nanoseconds result {0};
+    for (const LatencyRow& row : rows) result = (std::max)(result, row.*field);
+    return result;
+}
+
+int main() {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    const size_t batches = 200, batch = 64;
+    std::vector<INPUT_RECORD> script;
+    for (size_t b = 0; b < batches; ++b) {
+        for (size_t i = 0; i + 1 < batch; ++i) {
+            size_t n = b * batch + i;
+            script.push_back(DemoScreens::mouseMove(static_cast<SHORT>(12 + n % 36), static_cast<SHORT>(4 + (n / 36) % 14)));
+        }
+        script.push_back(b % 2 ? DemoScreens::keyPress(VK_BACK, 0) : DemoScreens::keyPress('A', L'a'));
+    }
+
+    EventManager& em = EventManager::getInstance();
+    em.coalescing().move = InputCoalescer::Keep;
+
+    std::cout << std::left << std::setw(10) << "mode" << std::right << std::setw(9) << "work us" << std::setw(10) << "ms"
+              << std::setw(16) << "key dispatch" << std::setw(10) << "p99" << std::setw(10) << "max"
+              << std::setw(14) << "mouse p99" << std::setw(13) << "paint p99" << std::setw(10) << "max"
+              << std::setw(8) << "frames" << std::setw(10) << "backlog" << std::setw(9) << "merged" << std::endl;
+    std::cout << std::left << std::setw(10) << "" << std::right << std::setw(9) << "" << std::setw(10) << ""
+              << std::setw(16) << "p50 ms" << std::setw(10) << "ms" << std::setw(10) << "ms"
+              << std::setw(14) << "dispatch ms" << std::setw(13) << "ms" << std::setw(10) << "ms" << std::endl;
+
+    for (int us : { 5, 20 }) {
+        for (bool prioritize : { false, true }) {
+            DemoScreens::Screen ui = DemoScreens::login();
+            ui.roots[0]->setFocus(true);    // Поле ввода подписано на клавиатуру
+            ui.draw();
+            auto work = std::chrono::microseconds(us);
+            em.addHandler<MOUSE_EVENT_RECORD>([work](const MOUSE_EVENT_RECORD& mer) {
+                if (mer.dwEventFlags == MOUSE_MOVED) spin(work);
+            });
+            em.lanes().prioritize = prioritize;
+
+            ScriptedInputSource source(script, static_cast<DWORD>(batch), std::chrono::milliseconds(1));
+            em.setInputSource(&source);
+            em.resetInputStats();
+            LatencyTracker::reset();
+            Render::stats = {};
+            auto start = Clock::now();
+            em.run();
+            double total = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            em.setInputSource(nullptr);
+
+            LatencyReport r = LatencyTracker::report();
+            const LatencyRow* keyDispatch = find(r.dispatch, "key");
+            const LatencyRow* mouse = find(r.dispatch, "mouse");
+            std::cout << std::left << std::setw(10) << (prioritize ? "lanes" : "ordered") << std::right << std::setw(9) << us
+                      << std::fixed << std::setprecision(2) << std::setw(10) << total
+                      << std::setw(16) << (keyDispatch ? ms(keyDispatch->p50) : 0) << std::setw(10) << (keyDispatch ? ms(keyDispatch->p99) : 0)
+                      << std::setw(10) << (keyDispatch ? ms(keyDispatch->max) : 0)
+                      << std::setw(14) << (mouse ? ms(mouse->p99) : 0)
+                      << std::setw(13) << ms(worst(r.paintByEvent, &LatencyRow::p99)) << std::setw(10) << ms(worst(r.paintByEvent, &LatencyRow::max))
+                      << std::setw(8) << Render::stats.presents << std::setw(10) << em.inputStats().maxBacklog << std::setw(9) << em.inputStats().mergedMoves << std::endl;
+            DemoScreens::release();
+        }
+    }
+
+    em.coalescing().move = InputCoalescer::Latest;
+    em.lanes().prioritize = true;
+    Render::disableBackBuffer();
+    return 0;
+}
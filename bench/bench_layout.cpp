@@ -0,0 +1,96 @@
+// Перерисовка по наведению: подписи Label / Button / CheckBox с кэшем раскладки (TextLayout)
+// и тем же кадром без кэша (как draw() был устроен раньше: substr, сборка строки, пересчёт выравнивания).
+// Главная колонка - allocs/frame: при смене выделения кэшированная подпись не выделяет память.
+// Формат вывода - см. Bench.h (--json / --csv / --out=file).
+#include <memory>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "EventManager.h"
+#include "FocusManager.h"
+#include "FrameScheduler.h"
+#include "Bench.h"
+#include "../BasicElements/Label.h"
+#include "../BasicElements/FiButton.h"
+#include "../BasicElements/CheckBox.h"
+
+struct Case {
+    std::string name;
+    std::function<void()> draw;
+};
+
+static constexpr WORD normalAttr = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+static constexpr WORD hoverAttr = BACKGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+
+// Курсор поочерёдно входит в контрол и уходит с него; перерисовка - через FrameScheduler, как в цикле событий
+static void hover(Control& control) {
+    static bool inside = false;
+    inside = !inside;
+    MOUSE_EVENT_RECORD mer {};
+    mer.dwEventFlags = MOUSE_MOVED;
+    mer.dwMousePosition = inside ? COORD{ static_cast<SHORT>(control.rect.Left + 1), static_cast<SHORT>(control.rect.Top + 1) } : COORD{ 100, 30 };
+    control.onMouse(mer);
+    FrameScheduler::drain();
+}
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::parseArgs(argc, argv);
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+
+    const std::wstring caption = L"Connected to build server, 42 jobs queued";
+    Label label({ 5, 2, 35, 4 }, caption);
+    FIButton button({ 5, 6, 35, 8 }, L"Запустить сборку");
+    CheckBox check({ 5, 10, 35, 12 }, L"Показывать скрытые файлы");
+    Render r;
+
+    std::vector<Case> cases {
+        { "Label/cached", [&] {
+            label.attr = label.attr == normalAttr ? hoverAttr : normalAttr;
+            label.draw();
+        } },
+        { "Label/uncached", [&] {
+            r.attr = r.attr == normalAttr ? hoverAttr : normalAttr;
+            SMALL_RECT inner { 6, 2, 34, 4 };
+            r.fillBox(label.rect);
+            r.DrawBox(label.rect);
+            std::wstring visible = caption.substr(0, CharWidth::fit(caption.data(), caption.size(), inner.Right - inner.Left));
+            r.drawTextLeft(visible, inner);
+        } },
+        { "Button/cached", [&] {
+            hover(button);
+        } },
+        { "Button/uncached", [&] {
+            r.attr = r.attr == normalAttr ? hoverAttr : normalAttr;
+            r.fillBox(button.rect);
+            r.DrawBox(button.rect);
+            r.drawTextCentered(button.text, button.rect);
+        } },
+        { "CheckBox/cached", [&] {
+            hover(check);
+        } },
+        { "CheckBox/uncached", [&] {
+            r.attr = r.attr == normalAttr ? hoverAttr : normalAttr;
+            r.fillBox(check.rect);
+            std::wstring displayText = check.checked ? L"[X] " : L"[ ] ";
+            displayText += check.text;
+            r.drawText(displayText, { static_cast<SHORT>(check.rect.Left + 1), static_cast<SHORT>((check.rect.Top + check.rect.Bottom) / 2) });
+        } },
+    };
+
+    std::vector<Bench::Result> results;
+    for (const Case& c : cases) {
+        Render::disableBackBuffer();
+        results.push_back(Bench::measure(c.name, "direct", screen, c.draw, options.minTime));
+
+        Render::enableBackBuffer();
+        results.push_back(Bench::measure(c.name, "surface", screen, [&] {
+            Render::Frame frame;
+            c.draw();
+        }, options.minTime));
+        Render::disableBackBuffer();
+    }
+
+    Bench::report(results, options);
+    return 0;
+}
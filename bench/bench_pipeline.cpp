@@ -0,0 +1,169 @@
+// Чтение ввода и обработчики в одном потоке (как было) и через конвейер EventManager
+// (поток чтения -> SPSC-очередь -> поток диспетчера). Ввод - записанный сценарий движений мыши
+// по проводнику (demo3), пачками по 16 событий; work - сколько микросекунд обработчик
+// дополнительно тратит на каждое событие (медленный draw()).
+// "max read gap" - самый долгий промежуток, когда источник ввода никто не читал.
+// pipeline/raw - конвейер без слияния записей, pipeline - со слиянием по умолчанию (InputCoalescer);
+// merged - сколько движений мыши поглощено слиянием.
+// В конце - сколько run() выходит после requestExit(), пока поток чтения ждёт источник.
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <string>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "EventManager.h"
+#include "InputSource.h"
+#include "DemoScreens.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Замеряет, сколько времени проходит между возвратом из read() и следующим вызовом
+class TimedSource : public InputSource {
+public:
+    InputSource& inner;
+    std::chrono::nanoseconds maxGap {0};
+
+    explicit TimedSource(InputSource& s) : inner(s) {}
+
+    bool read(INPUT_RECORD* records, DWORD capacity, DWORD& count) override {
+        auto now = Clock::now();
+        if (started) maxGap = (std::max)(maxGap, std::chrono::duration_cast<std::chrono::nanoseconds>(now - last));
+        bool ok = inner.read(records, capacity, count);
+        last = Clock::now();
+        started = true;
+        return ok;
+    }
+
+    void cancel() override { inner.cancel(); }
+    void restart() override { inner.restart(); }
+
+private:
+    Clock::time_point last;
+    bool started {false};
+};
+
+struct Result {
+    double ms {0};
+    double maxGapUs {0};
+    size_t maxDepth {0};
+    size_t stalls {0};
+    double enqueueNs {0};   // на событие
+    double dispatchNs {0};  // на событие
+    size_t merged {0};
+};
+
+static void spin(std::chrono::microseconds work) {
+    auto until = Clock::now() + work;
+    while (Clock::now() < until) {}
+}
+
+// Прежний цикл: прочитали пачку - тут же раздали её обработчикам
+Result runInline(InputSource& source) {
+    TimedSource timed(source);
+    INPUT_RECORD records[128];
+    DWORD count = 0;
+    auto start = Clock::now();
+    while (timed.read(records, 128, count)) {
+        std::lock_guard<std::recursive_mutex> lock(FrameScheduler::uiMutex());
+        Render::Frame frame;
+        for (DWORD i = 0; i < count; ++i) EventManager::getInstance().dispatch(records[i]);
+        FrameScheduler::drain();
+    }
+    Result r;
+    r.ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    r.maxGapUs = timed.maxGap.count() / 1e3;
+    return r;
+}
+
+Result runPipeline(InputSource& source, size_t events, bool coalesce) {
+    TimedSource timed(source);
+    EventManager& em = EventManager::getInstance();
+    em.coalescing().move = coalesce ? InputCoalescer::Latest : InputCoalescer::Keep;
+    em.setInputSource(&timed);
+    em.resetInputStats();
+    auto start = Clock::now();
+    em.run();   // Вернётся, когда сценарий кончится и всё будет разобрано
+    if (em.inputStats().dispatched < events) std::cerr << "pipeline lost input" << std::endl;
+    Result r;
+    r.ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    em.setInputSource(nullptr);
+
+    const InputStats& s = em.inputStats();
+    r.maxGapUs = timed.maxGap.count() / 1e3;
+    r.maxDepth = s.maxDepth;
+    r.stalls = s.readerStalls;
+    r.enqueueNs = static_cast<double>(s.enqueueNs) / events;
+    r.dispatchNs = static_cast<double>(s.dispatchNs) / events;
+    r.merged = s.mergedMoves;
+    em.coalescing().move = InputCoalescer::Latest;
+    return r;
+}
+
+// Поток чтения спит в секундной паузе источника; requestExit() из другого потока
+static void exitLatency() {
+    EventManager& em = EventManager::getInstance();
+    ScriptedInputSource idle(std::vector<INPUT_RECORD>(4, DemoScreens::mouseMove(1, 1)), 1, std::chrono::seconds(1));
+    em.setInputSource(&idle);
+    const int rounds = 20;
+    double total = 0, worst = 0;
+    for (int i = 0; i < rounds; ++i) {
+        idle.rewind();
+        Clock::time_point requested;
+        std::thread exiter([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            requested = Clock::now();
+            em.requestExit();
+        });
+        em.run();
+        auto returned = Clock::now();
+        exiter.join();
+        double us = std::chrono::duration<double, std::micro>(returned - requested).count();
+        total += us;
+        worst = (std::max)(worst, us);
+    }
+    em.setInputSource(nullptr);
+    std::cout << std::endl << "requestExit -> run() returned: avg " << std::fixed << std::setprecision(1)
+              << total / rounds << " us, max " << worst << " us (" << rounds << " runs)" << std::endl;
+}
+
+int main() {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+
+    DemoScreens::Screen explorer = DemoScreens::explorer();
+    explorer.draw();
+
+    const size_t events = 4000;
+    std::vector<INPUT_RECORD> script;
+    for (size_t i = 0; i < events; ++i) script.push_back(DemoScreens::mouseMove(static_cast<SHORT>(10 + i % 30), static_cast<SHORT>(3 + (i / 30) % 32)));
+
+    std::cout << std::left << std::setw(14) << "mode" << std::right << std::setw(9) << "work us"
+              << std::setw(10) << "ms" << std::setw(16) << "max read gap us" << std::setw(11) << "max depth"
+              << std::setw(9) << "stalls" << std::setw(14) << "enqueue ns/ev" << std::setw(15) << "dispatch ns/ev" << std::setw(9) << "merged" << std::endl;
+    for (int us : { 0, 5, 20 }) {
+        auto work = std::chrono::microseconds(us);
+        auto slow = EventManager::getInstance().addHandler<MOUSE_EVENT_RECORD>([work](const MOUSE_EVENT_RECORD&) { spin(work); });
+        for (const char* mode : { "inline", "pipeline/raw", "pipeline" }) {
+            bool pipeline = mode[0] == 'p';
+            ScriptedInputSource source(script, 16, std::chrono::microseconds(50));
+            Result r = pipeline ? runPipeline(source, events, std::string(mode) == "pipeline") : runInline(source);
+            std::cout << std::left << std::setw(14) << mode << std::right << std::setw(9) << us
+                      << std::fixed << std::setprecision(1) << std::setw(10) << r.ms << std::setw(16) << r.maxGapUs
+                      << std::setw(11) << r.maxDepth << std::setw(9) << r.stalls;
+            if (pipeline) std::cout << std::setw(14) << r.enqueueNs << std::setw(15) << r.dispatchNs << std::setw(9) << r.merged;
+            else std::cout << std::setw(14) << "-" << std::setw(15) << "-" << std::setw(9) << "-";
+            std::cout << std::endl;
+        }
+        EventManager::getInstance().removeHandler<MOUSE_EVENT_RECORD>(slow);
+    }
+
+    exitLatency();
+
+    DemoScreens::release();
+    Render::disableBackBuffer();
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Стратегии блокировки HandlerContainer (см. HandlerContainer.h) на одном списке из 16 обработчиков.
+// Первая таблица - один поток: цена раздачи события и пары подписка+отписка без конкуренции.
+// Вторая - N потоков раздают события и N потоков одновременно подписываются и отписываются
+// (без пауз, худший случай). events/ms и subs/ms - суммарно по потокам; max stall us - самая
+// долгая раздача одного события у издателей (столько издатель ждал блокировку).
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "Platform.h"
+#include "HandlerContainer.h"
+
+using Clock = std::chrono::steady_clock;
+
+static thread_local long long sink = 0;
+static constexpr size_t baseHandlers = 16;
+
+template <typename Locking>
+void fill(HandlerContainer<int, Locking>& container) {
+    for (size_t i = 0; i < baseHandlers; ++i) container.addHandler([](const int& v) { sink += v; });
+}
+
+template <typename Locking>
+void uncontended(const char* name) {
+    HandlerContainer<int, Locking> container;
+    fill(container);
+    const size_t rounds = 1'000'000;
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) container.invokeHandlers(static_cast<int>(i));
+    double eventNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds;
+
+    start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) {
+        auto id = container.addHandler([](const int& v) { sink -= v; });
+        container.removeHandler(id);
+    }
+    double subNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds;
+
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << eventNs << std::setw(16) << subNs << std::endl;
+}
+
+template <typename Locking>
+void contended(const char* name, int threads) {
+    HandlerContainer<int, Locking> container;
+    fill(container);
+    const auto duration = std::chrono::milliseconds(200);
+
+    std::atomic<bool> go {false}, done {false};
+    std::atomic<size_t> events {0}, subs {0};
+    std::atomic<long long> maxStallNs {0};
+    std::vector<std::thread> pool;
+
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            while (!go) std::this_thread::yield();
+            size_t n = 0;
+            long long worst = 0;
+            while (!done) {
+                auto before = Clock::now();
+                container.invokeHandlers(static_cast<int>(n));
+                worst = (std::max)(worst, static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count()));
+                ++n;
+            }
+            events += n;
+            long long seen = maxStallNs;
+            while (worst > seen && !maxStallNs.compare_exchange_weak(seen, worst)) {}
+        });
+        pool.emplace_back([&] {
+            while (!go) std::this_thread::yield();
+            size_t n = 0;
+            while (!done) {
+                auto id = container.addHandler([](const int& v) { sink -= v; });
+                container.removeHandler(id);
+                ++n;
+            }
+            subs += n;
+        });
+    }
+
+    go = true;
+    std::this_thread::sleep_for(duration);
+    done = true;
+    for (auto& thread : pool) thread.join();
+
+    double ms = static_cast<double>(duration.count());
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(9) << threads
+              << std::fixed << std::setprecision(1) << std::setw(14) << events / ms << std::setw(12) << subs / ms
+              << std::setw(15) << maxStallNs / 1e3 << std::endl;
+}
+
+int main() {
+    std::cout << std::left << std::setw(16) << "policy" << std::right << std::setw(12) << "ns/event"
+              << std::setw(16) << "ns/sub+unsub" << std::endl;
+    uncontended<SingleThreaded>("SingleThreaded");
+    uncontended<Locked>("Locked");
+    uncontended<SharedLocked>("SharedLocked");
+    uncontended<LockFree>("LockFree");
+
+    // SingleThreaded в конкурентной таблице не участвует: из нескольких потоков его звать нельзя
+    std::cout << std::endl << std::left << std::setw(16) << "policy" << std::right << std::setw(9) << "threads"
+              << std::setw(14) << "events/ms" << std::setw(12) << "subs/ms" << std::setw(15) << "max stall us" << std::endl;
+    for (int threads : { 1, 2, 8 }) {
+        contended<Locked>("Locked", threads);
+        contended<SharedLocked>("SharedLocked", threads);
+        contended<LockFree>("LockFree", threads);
+    }
+    return 0;
+}
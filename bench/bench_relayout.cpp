@@ -0,0 +1,138 @@
+// Перераскладка вертикального ScrollContainer на 10 000 подписей, когда одна из них меняет высоту.
+//   full        - rearrangeControls(): все дети перемеряются и ставятся заново, прокрутка - по всем детям;
+//   incremental - setRect() ребёнка помечает путь к корню, FrameScheduler::layout() перемеряет только его
+//                 и сдвигает детей за ним; длина содержимого для maxScroll берётся из кэша контейнера.
+// Ребёнок в начале списка сдвигает всех за собой, в конце - почти никого.
+// moved - дети, чей rect изменился за одну перераскладку; check - обе раскладки дают одно и то же.
+// removal - то же после removeControl при каждом выравнивании: инкрементная раскладка против полной.
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "FrameScheduler.h"
+#include "../BasicElements/ScrollContainer.h"
+#include "../BasicElements/Label.h"
+
+struct Result {
+    double usPerRelayout {0};
+    double moved {0};
+    int maxScroll {0};
+    SHORT lastBottom {0};
+};
+
+static size_t countMoved(const std::vector<SMALL_RECT>& before, const ScrollContainer& list) {
+    size_t moved = 0;
+    for (size_t i = 0; i < before.size(); ++i) {
+        const SMALL_RECT& a = before[i];
+        const SMALL_RECT& b = list.controls[i]->rect;
+        moved += a.Top != b.Top || a.Bottom != b.Bottom || a.Left != b.Left || a.Right != b.Right;
+    }
+    return moved;
+}
+
+// Ребёнок index по очереди становится выше на строку и возвращается обратно
+template <typename F>
+static Result measure(ScrollContainer& list, size_t index, F&& relayout) {
+    const int rounds = 200;
+    Control& child = *list.controls[index];
+    std::vector<SMALL_RECT> before;
+    for (auto& ctrl : list.controls) before.push_back(ctrl->rect);
+
+    Result r;
+    std::chrono::nanoseconds total {0};
+    size_t moved = 0;
+    for (int i = 0; i < rounds; ++i) {
+        SMALL_RECT grown = child.rect;
+        grown.Bottom = static_cast<SHORT>(grown.Bottom + (i % 2 ? -1 : 1));
+        auto start = std::chrono::steady_clock::now();
+        relayout(child, grown);
+        total += std::chrono::steady_clock::now() - start;
+        if (i == 0) moved = countMoved(before, list);
+        FrameScheduler::drain();    // Перерисовка сдвинутой полосы - вне замера
+    }
+    r.usPerRelayout = std::chrono::duration<double, std::micro>(total).count() / rounds;
+    r.moved = static_cast<double>(moved);
+    r.maxScroll = list.maxScroll;
+    r.lastBottom = list.controls.back()->rect.Bottom;
+    return r;
+}
+
+static std::vector<SMALL_RECT> rectsOf(const Container& box) {
+    std::vector<SMALL_RECT> rects;
+    for (auto& ctrl : box.controls) rects.push_back(ctrl->rect);
+    return rects;
+}
+
+static bool sameRects(const std::vector<SMALL_RECT>& a, const std::vector<SMALL_RECT>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].Left != b[i].Left || a[i].Top != b[i].Top || a[i].Right != b[i].Right || a[i].Bottom != b[i].Bottom) return false;
+    }
+    return true;
+}
+
+// Удаление первого, среднего и последнего из пяти детей: layout() должен поставить остальных туда же,
+// куда и rearrangeControls()
+static bool removalMatches(Container::Alignment alignment) {
+    for (size_t index : { size_t(0), size_t(2), size_t(4) }) {
+        Container box({ 0, 0, 30, 30 }, Container::Vertical);
+        box.alignment = alignment;
+        for (int i = 0; i < 5; ++i) box.addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 20, static_cast<SHORT>(2 + i % 2) }, L"item", 0));
+        box.rearrangeControls();
+        box.removeControl(box.controls[index]);
+        FrameScheduler::layout();
+        std::vector<SMALL_RECT> incremental = rectsOf(box);
+        box.rearrangeControls();
+        if (!sameRects(incremental, rectsOf(box))) return false;
+    }
+    FrameScheduler::drain();
+    return true;
+}
+
+int main() {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    const size_t children = 10000;
+    ScrollContainer list({ 0, 0, 60, 39 }, Container::Vertical);
+    list.spacing = 0;
+    list.padding = { 1, 1, 1, 1 };
+    for (size_t i = 0; i < children; ++i) list.addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 1 }, L"row " + std::to_wstring(i), 0));
+    list.rearrangeControls();
+    FrameScheduler::drain();
+    list.draw();
+
+    std::cout << std::left << std::setw(10) << "child" << std::setw(13) << "mode" << std::right << std::setw(14) << "us/relayout"
+              << std::setw(9) << "moved" << std::setw(11) << "maxScroll" << std::setw(8) << "check" << std::endl;
+    for (size_t index : { size_t(0), children / 2, children - 1 }) {
+        Result full = measure(list, index, [&](Control& child, const SMALL_RECT& r) {
+            child.rect = r;     // Как до раскладки в два прохода: без пометок, всё заново
+            list.rearrangeControls();
+        });
+        Result incremental = measure(list, index, [&](Control& child, const SMALL_RECT& r) {
+            child.setRect(r);
+            FrameScheduler::layout();
+        });
+        bool same = full.maxScroll == incremental.maxScroll && full.lastBottom == incremental.lastBottom;
+        for (auto [name, r] : { std::pair{ "full", full }, std::pair{ "incremental", incremental } }) {
+            std::cout << std::left << std::setw(10) << index << std::setw(13) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(14) << r.usPerRelayout << std::setprecision(0) << std::setw(9) << r.moved
+                      << std::setw(11) << r.maxScroll << std::setw(8) << (same ? "ok" : "DIFFERS") << std::endl;
+        }
+    }
+
+    std::cout << std::endl << std::left << std::setw(10) << "removal";
+    for (auto [name, alignment] : { std::pair{ "start", Container::Start }, std::pair{ "center", Container::Center }, std::pair{ "end", Container::End } }) {
+        std::cout << name << (removalMatches(alignment) ? " ok  " : " DIFFERS  ");
+    }
+    std::cout << std::endl;
+
+    Render::disableBackBuffer();
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Скорость отрисовки примитивов Render, контейнеров и экранов demo1-demo5 без консоли (HeadlessBackend).
+// direct  - прямой режим: каждый примитив сразу уходит в бэкенд;
+// surface - задний буфер: экран очищается (вне замера), кадр рисуется заново целиком и выводится одним present().
+// Формат вывода - см. Bench.h (--json / --csv / --out=file).
+#include <memory>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "Bench.h"
+#include "DemoScreens.h"
+
+struct Case {
+    std::string name;
+    std::function<void()> draw;
+};
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::parseArgs(argc, argv);
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+
+    Render r;
+    r.attr = BACKGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+    SMALL_RECT box { 10, 5, 89, 24 };
+    SMALL_RECT line { 10, 5, 89, 7 };
+    const std::wstring text = L"The quick brown fox jumps over the dog";
+
+    auto container = std::make_shared<Container>(SMALL_RECT{ 5, 5, 45, 35 }, Container::Vertical);
+    container->bordered = true;
+    container->padding = { 1, 1, 1, 1 };
+    for (int i = 0; i < 8; ++i) container->addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 2 }, L"Label " + std::to_wstring(i)));
+    container->rearrangeControls();
+    DemoScreens::Screen scroll = DemoScreens::scroll();
+
+    std::vector<Case> cases {
+        { "fillBox 80x20",          [&] { r.fillBox(box); } },
+        { "DrawBox 80x20",          [&] { r.DrawBox(box); } },
+        { "drawTextCentered",       [&] { r.drawTextCentered(text, line); } },
+        { "drawTextLeft",           [&] { r.drawTextLeft(text, line); } },
+        { "drawTextRight",          [&] { r.drawTextRight(text, line); } },
+        { "Container::draw",        [&] { container->draw(); } },
+        { "ScrollContainer::draw",  [&] { scroll.roots.front()->draw(); } },
+    };
+
+    // Экраны демо: обработчики ввода не нужны, только отрисовка
+    std::vector<DemoScreens::Screen> screens;
+    for (const auto& make : DemoScreens::all()) screens.push_back(make());
+    for (auto& s : screens) cases.push_back({ "screen/" + s.name, [&s] { for (auto& root : s.roots) root->draw(); } });
+
+    std::vector<Bench::Result> results;
+    for (const Case& c : cases) {
+        Render::disableBackBuffer();
+        results.push_back(Bench::measure(c.name, "direct", screen, c.draw, options.minTime));
+
+        Render::enableBackBuffer();
+        results.push_back(Bench::measure(c.name, "surface", screen, [&] {
+            Render::Frame frame;
+            c.draw();
+        }, options.minTime, [] { Render::clearScreen(); })); // front = пустой экран: кадр выводится целиком
+        Render::disableBackBuffer();
+    }
+
+    Bench::report(results, options);
+    DemoScreens::release();
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Воспроизведение двоичного следа ввода (InputTrace.h) на экране в памяти.
+//   bench_replay                          - следы, собранные из сценариев DemoScreens, по всем экранам;
+//   bench_replay session.wuit --screen=explorer [--realtime]
+//                                         - записанный сеанс на выбранном экране;
+//   --save=dir                            - сохранить собранные следы как dir/<экран>.wuit;
+//   --latency                             - после каждого экрана задержки ввод -> кадр (LatencyTracker).
+// По умолчанию пачки следа идут подряд через EventManager::dispatchBatch без потоков - результат
+// повторяем от запуска к запуску (hash - содержимое экрана после воспроизведения, второй прогон
+// обязан его повторить). --realtime - через конвейер EventManager с записанными паузами.
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "EventManager.h"
+#include "InputTrace.h"
+#include "LatencyTracker.h"
+#include "DemoScreens.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Replay {
+    double wallMs {0};
+    double handlerMs {0};
+    size_t frames {0};
+    size_t draws {0};
+    size_t cells {0};
+    uint64_t hash {0};
+};
+
+static uint64_t screenHash(HeadlessBackend& screen) {
+    uint64_t h = 1469598103934665603ull;   // FNV-1a
+    COORD size = screen.size();
+    for (SHORT y = 0; y < size.Y; ++y)
+        for (SHORT x = 0; x < size.X; ++x) {
+            const Cell& cell = screen.at(x, y);
+            for (uint64_t v : { static_cast<uint64_t>(cell.ch), static_cast<uint64_t>(cell.attr) }) {
+                h ^= v;
+                h *= 1099511628211ull;
+            }
+        }
+    return h;
+}
+
+static Replay replay(const std::string& screenName, const InputTrace& trace, bool realtime) {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    DemoScreens::Screen ui;
+    for (auto& make : DemoScreens::all()) {
+        ui = make();
+        if (ui.name == screenName) break;
+        DemoScreens::release();
+        ui = {};
+    }
+    ui.draw();
+
+    EventManager& em = EventManager::getInstance();
+    em.resetInputStats();
+    FrameScheduler::resetStats();
+    LatencyTracker::reset();
+    Render::stats = {};
+    screen.resetStats();
+
+    TraceInputSource source(trace, realtime ? TraceInputSource::Recorded : TraceInputSource::AsFastAsPossible);
+    auto start = Clock::now();
+    if (realtime) {
+        em.setInputSource(&source);
+        em.run();   // След кончился и разобран
+        em.setInputSource(nullptr);
+    } else {
+        INPUT_RECORD batch[128];
+        DWORD count = 0;
+        while (source.read(batch, 128, count)) {
+            std::lock_guard<std::recursive_mutex> lock(FrameScheduler::uiMutex());
+            em.dispatchBatch(batch, count);
+        }
+    }
+
+    Replay r;
+    r.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    r.handlerMs = em.inputStats().dispatchNs / 1e6;
+    r.frames = Render::stats.presents;
+    r.draws = FrameScheduler::stats.draws;
+    r.cells = screen.stats.cells;
+    r.hash = screenHash(screen);
+
+    DemoScreens::release();
+    Render::disableBackBuffer();
+    Render::setBackend(nullptr);
+    return r;
+}
+
+// Сеанс из сценария экрана: повторы сценария пачками по 4 записи каждые 4 мс (мышь ~1000 Гц)
+static InputTrace synthesize(const DemoScreens::Screen& s) {
+    InputTrace trace;
+    std::vector<INPUT_RECORD> session;
+    for (int pass = 0; pass < 50; ++pass) session.insert(session.end(), s.script.begin(), s.script.end());
+    for (size_t i = 0; i < session.size(); i += 4) {
+        trace.append(std::chrono::milliseconds(4 * (i / 4)), session.data() + i, (std::min)(size_t(4), session.size() - i));
+    }
+    return trace;
+}
+
+static void header() {
+    std::cout << std::left << std::setw(12) << "screen" << std::right << std::setw(9) << "records" << std::setw(9) << "batches"
+              << std::setw(11) << "bytes/rec" << std::setw(10) << "wall ms" << std::setw(12) << "handler ms"
+              << std::setw(8) << "frames" << std::setw(8) << "draws" << std::setw(9) << "cells"
+              << std::setw(18) << "hash" << std::setw(10) << "repeat" << std::endl;
+}
+
+static void report(const std::string& name, const InputTrace& trace, size_t bytes, bool realtime, bool latency) {
+    Replay first = replay(name, trace, realtime);
+    Replay second = replay(name, trace, realtime);
+    std::cout << std::left << std::setw(12) << name << std::right << std::setw(9) << trace.records.size()
+              << std::setw(9) << trace.batches.size() << std::fixed << std::setprecision(1)
+              << std::setw(11) << (trace.records.empty() ? 0.0 : static_cast<double>(bytes) / trace.records.size())
+              << std::setw(10) << first.wallMs << std::setw(12) << std::setprecision(3) << first.handlerMs
+              << std::setw(8) << first.frames << std::setw(8) << first.draws << std::setw(9) << first.cells
+              << std::setw(18) << std::hex << first.hash << std::dec
+              << std::setw(10) << (first.hash == second.hash ? "same" : "DIFFERS") << std::endl;
+    if (latency) {
+        LatencyTracker::dump(std::cout);    // Второго прогона
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string path, screenName = "explorer", saveDir;
+    bool realtime = false, latency = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--realtime") realtime = true;
+        else if (arg == "--latency") latency = true;
+        else if (arg.rfind("--screen=", 0) == 0) screenName = arg.substr(9);
+        else if (arg.rfind("--save=", 0) == 0) saveDir = arg.substr(7);
+        else path = arg;
+    }
+
+    header();
+    if (!path.empty()) {
+        std::ifstream file(path, std::ios::binary);
+        InputTrace trace;
+        if (!trace.load(file)) std::cerr << path << ": trace is damaged, replaying " << trace.batches.size() << " complete batches" << std::endl;
+        report(screenName, trace, static_cast<size_t>(std::ifstream(path, std::ios::binary | std::ios::ate).tellg()), realtime, latency);
+        return 0;
+    }
+
+    for (auto& make : DemoScreens::all()) {
+        DemoScreens::Screen s = make();
+        std::string name = s.name;
+        InputTrace recorded = synthesize(s);
+        DemoScreens::release();
+
+        // Через двоичный формат туда и обратно: воспроизводится то, что прочитано из следа
+        std::stringstream bytes;
+        recorded.save(bytes);
+        std::string encoded = bytes.str();
+        InputTrace trace;
+        if (!trace.load(bytes) || trace.records.size() != recorded.records.size()) {
+            std::cerr << name << ": trace round trip failed" << std::endl;
+            return 1;
+        }
+        if (!saveDir.empty()) std::ofstream(saveDir + "/" + name + ".wuit", std::ios::binary) << encoded;
+        report(name, trace, encoded.size(), realtime, latency);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Поток движений мыши по калькулятору (demo2): сколько раз перерисовываются элементы
+// при немедленной отрисовке и при FrameScheduler::Drain. События приходят пачками,
+// как из ReadConsoleInput; кадр в режиме Drain рисуется, когда очередь пуста.
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "FrameScheduler.h"
+#include "DemoScreens.h"
+
+struct Result {
+    size_t draws {0};
+    size_t frames {0};
+    size_t merged {0};
+    size_t cells {0};
+    double us {0};
+};
+
+// burst - сколько событий лежит в очереди к моменту очередного чтения
+Result flood(FrameScheduler::Mode mode, size_t events, size_t burst) {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = mode;
+
+    DemoScreens::Screen calc = DemoScreens::calculator();
+    calc.draw();
+    FrameScheduler::resetStats();
+    Render::stats = {};
+    screen.resetStats();
+
+    // Мышь ходит зигзагом по всем кнопкам
+    std::deque<INPUT_RECORD> queue;
+    for (size_t i = 0; i < events; ++i) queue.push_back(DemoScreens::mouseMove(static_cast<SHORT>(10 + (i * 7) % 44), static_cast<SHORT>(6 + (i / 44) % 12)));
+
+    auto start = std::chrono::steady_clock::now();
+    std::deque<INPUT_RECORD> arrived;
+    while (!queue.empty() || !arrived.empty()) {
+        for (size_t i = 0; i < burst && !queue.empty(); ++i) {
+            arrived.push_back(queue.front());
+            queue.pop_front();
+        }
+        // Один ReadConsoleInput: до 128 событий
+        Render::Frame frame;
+        for (size_t i = 0; i < 128 && !arrived.empty(); ++i) {
+            EventManager::getInstance().dispatch(arrived.front());
+            arrived.pop_front();
+        }
+        if (mode == FrameScheduler::Drain && arrived.empty()) FrameScheduler::drain();
+    }
+    Result r;
+    r.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    r.draws = FrameScheduler::stats.draws;
+    r.frames = Render::stats.presents;
+    r.merged = FrameScheduler::stats.merged;
+    r.cells = Render::stats.cellsPresented;
+
+    DemoScreens::release();
+    Render::disableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+    return r;
+}
+
+int main() {
+    const size_t events = 2000;
+    std::cout << std::left << std::setw(11) << "mode" << std::right << std::setw(7) << "burst"
+              << std::setw(10) << "presents" << std::setw(10) << "draws" << std::setw(10) << "merged"
+              << std::setw(12) << "cells" << std::setw(12) << "us total" << std::endl;
+    for (size_t burst : { size_t(1), size_t(16), size_t(256) }) {
+        for (FrameScheduler::Mode mode : { FrameScheduler::Immediate, FrameScheduler::Drain }) {
+            Result r = flood(mode, events, burst);
+            std::cout << std::left << std::setw(11) << (mode == FrameScheduler::Immediate ? "immediate" : "drain")
+                      << std::right << std::setw(7) << burst
+                      << std::setw(10) << r.frames << std::setw(10) << r.draws << std::setw(10) << r.merged
+                      << std::setw(12) << r.cells << std::setw(12) << std::fixed << std::setprecision(0) << r.us << std::endl;
+        }
+    }
+    return 0;
+}
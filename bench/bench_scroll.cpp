@@ -0,0 +1,144 @@
+// Прокрутка колесом ScrollContainer из N подписей, по щелчку на кадр (400 щелчков вниз и обратно):
+//   shift   - ScrollContainer: одно смещение, нарисованное сдвигается блоком, рисуются открывшиеся строки;
+//   repaint - как было раньше: щелчок переставляет всех детей и перерисовывает окно целиком.
+// us/tick - щелчок и кадр; cells - ячейки, дошедшие до бэкенда за щелчок; moves - сдвиги блоком за щелчок.
+// У shift us/tick и cells от N не зависят; lines - строк за щелчок (1 или 3 при слитых событиях колеса).
+// clip - нажатие под окном прокрутки не достаётся частично видимому ребёнку, только элементу под окном.
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "FrameScheduler.h"
+#include "DemoScreens.h"
+#include "CheckBox.h"
+
+// Прежняя прокрутка: все дети встают заново, окно перерисовывается целиком
+class RepaintScroll : public ScrollContainer {
+public:
+    using ScrollContainer::ScrollContainer;
+
+    void scrollBy(int lines) override {
+        int target = (std::clamp)(scrollY + lines, 0, maxScroll);
+        if (target == scrollY) return;
+        scrollY = target;
+        fullPass = true;
+        relayout(false);
+        invalidate();
+    }
+};
+
+struct Result {
+    double usPerTick {0};
+    double cells {0};
+    double moves {0};
+};
+
+static Result wheel(ScrollContainer& list, HeadlessBackend& screen, int lines) {
+    const int ticks = 400;
+    screen.resetStats();
+    Render::stats = {};
+    std::chrono::nanoseconds total {0};
+    for (int i = 0; i < ticks; ++i) {
+        short delta = static_cast<short>(lines * WHEEL_DELTA);
+        INPUT_RECORD record = DemoScreens::mouseWheel(10, 10, i < ticks / 2 ? -delta : delta);
+        auto start = std::chrono::steady_clock::now();
+        list.onMouse(record.Event.MouseEvent);
+        FrameScheduler::drain();
+        total += std::chrono::steady_clock::now() - start;
+    }
+    Result r;
+    r.usPerTick = std::chrono::duration<double, std::micro>(total).count() / ticks;
+    r.cells = static_cast<double>(screen.stats.cells) / ticks;
+    r.moves = static_cast<double>(Render::stats.scrolls) / ticks;
+    return r;
+}
+
+template <class List>
+static void fill(List& list, size_t items) {
+    list.bordered = false;
+    list.spacing = 0;
+    for (size_t i = 0; i < items; ++i) list.addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 1 }, L"row " + std::to_wstring(i), 0));
+    list.rearrangeControls();
+    list.draw();
+    FrameScheduler::drain();
+}
+
+static void print(size_t items, const char* name, int lines, const Result& r) {
+    std::cout << std::left << std::setw(8) << items << std::setw(9) << name << std::right << std::setw(6) << lines
+              << std::fixed << std::setprecision(2) << std::setw(11) << r.usPerTick << std::setprecision(1)
+              << std::setw(10) << r.cells << std::setw(10) << r.moves << std::endl;
+}
+
+// Ребёнок, торчащий из окна прокрутки вниз, и флажок прямо под окном: нажатие под окном
+// переключает только флажок, нажатие по видимой части ребёнка - только ребёнка
+static bool clippedHits() {
+    ScrollContainer list({ 5, 3, 60, 20 }, Container::Vertical);
+    list.spacing = 0;
+    std::vector<std::shared_ptr<CheckBox>> rows;
+    for (int i = 0; i < 10; ++i) {
+        rows.push_back(std::make_shared<CheckBox>(SMALL_RECT{ 0, 0, 40, 4 }, L"row " + std::to_wstring(i)));
+        list.addControl(rows.back());
+    }
+    list.rearrangeControls();
+    list.scrollBy(2);
+    FrameScheduler::drain();
+
+    const SMALL_RECT view = list.viewport();
+    std::shared_ptr<CheckBox> cut;
+    for (auto& row : rows) if (row->rect.Top <= view.Bottom && row->rect.Bottom > view.Bottom) cut = row;
+    if (!cut || cut->rect.Bottom <= list.rect.Bottom) return false;
+    CheckBox below({ 6, static_cast<SHORT>(list.rect.Bottom + 1), 40, static_cast<SHORT>(list.rect.Bottom + 3) }, L"below");
+
+    auto press = [](SHORT y) {
+        MOUSE_EVENT_RECORD mer {};
+        mer.dwMousePosition = { 10, y };
+        mer.dwButtonState = FROM_LEFT_1ST_BUTTON_PRESSED;
+        MouseRouter::route(mer);
+        mer.dwButtonState = 0;
+        MouseRouter::route(mer);
+        FrameScheduler::drain();
+    };
+    press(view.Bottom);                 // Видимая часть ребёнка
+    bool ok = cut->checked && !below.checked;
+    press(below.rect.Top);              // Под окном: ребёнок туда заходит, но не виден
+    ok = ok && cut->checked && below.checked;
+    return ok;
+}
+
+int main() {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    std::cout << std::left << std::setw(8) << "items" << std::setw(9) << "scroll" << std::right << std::setw(6) << "lines"
+              << std::setw(11) << "us/tick" << std::setw(10) << "cells" << std::setw(10) << "moves" << std::endl;
+    // До 10 000: дальше строки не влезают в координаты SHORT
+    for (size_t items : { size_t(1000), size_t(3000), size_t(10000) }) {
+        for (int lines : { 1, 3 }) {
+            {
+                ScrollContainer list({ 0, 0, 119, 39 }, Container::Vertical);
+                fill(list, items);
+                print(items, "shift", lines, wheel(list, screen, lines));
+            }
+            DemoScreens::release();
+            {
+                RepaintScroll list({ 0, 0, 119, 39 }, Container::Vertical);
+                fill(list, items);
+                print(items, "repaint", lines, wheel(list, screen, lines));
+            }
+            DemoScreens::release();
+        }
+    }
+
+    std::cout << std::endl << "clip " << (clippedHits() ? "ok" : "DIFFERS") << std::endl;
+    DemoScreens::release();
+
+    Render::disableBackBuffer();
+    Render::setBackend(nullptr);
+    return 0;
+}
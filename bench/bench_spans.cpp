@@ -0,0 +1,58 @@
+// Вызовы консольного API на одну отрисовку каждого виджета в прямом режиме (без заднего буфера).
+// Примитивы Render пишут отрезками, поэтому вызовов должно быть порядка числа строк виджета, а не ячеек.
+// Вне Windows вызовы считает ConsoleStub; на Windows печатается только геометрия.
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include "Platform.h"
+#include "Render.h"
+#include "DemoScreens.h"
+
+#ifdef _WIN32
+#define API_CALLS() size_t(0)
+#define RESET_API_CALLS()
+#else
+#define API_CALLS() ConsoleStub::stats.calls
+#define RESET_API_CALLS() ConsoleStub::resetStats()
+#endif
+
+void report(const char* name, Control& control) {
+    RESET_API_CALLS();
+    control.draw();
+    const SMALL_RECT& r = control.rect;
+    size_t rows = r.Bottom - r.Top + 1;
+    size_t cells = rows * (r.Right - r.Left + 1);
+    std::cout << std::left << std::setw(18) << name
+              << std::right << std::setw(8) << rows << std::setw(8) << cells << std::setw(12) << API_CALLS() << std::endl;
+}
+
+int main() {
+    std::cout << std::left << std::setw(18) << "widget"
+              << std::right << std::setw(8) << "rows" << std::setw(8) << "cells" << std::setw(12) << "api calls" << std::endl;
+
+    Label label({ 2, 2, 41, 4 }, L"Label");
+    report("Label", label);
+    Label wide({ 2, 2, 101, 30 }, L"Wide label");
+    report("Label 100x29", wide);
+    FIButton button({ 2, 2, 21, 4 }, L"Button");
+    report("FIButton", button);
+    CheckBox check({ 2, 2, 41, 4 }, L"Remember Me");
+    report("CheckBox", check);
+    TextBox text({ 2, 2, 41, 4 }, L"Login");
+    report("TextBox", text);
+    DemoScreens::ScrollCharacter character({ 2, 2, 5, 5 }, L'A');
+    report("ScrollCharacter", character);
+
+    Container container({ 5, 5, 45, 25 }, Container::Vertical);
+    container.bordered = true;
+    report("Container", container);
+
+    auto grid = DemoScreens::grid();
+    report("demo4 grid", *grid.roots.front());
+    auto scroll = DemoScreens::scroll();
+    report("demo5 scroll", *scroll.roots.front());
+
+    DemoScreens::release();
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Сравнение прямого вывода и заднего буфера: вызовы консольного API и время перерисовки.
+// Вне Windows консоль подменяется заглушкой в памяти, поэтому числа воспроизводимы на Linux.
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "VtBackend.h"
+#include "EventManager.h"
+#include "FocusManager.h"
+#include "FrameScheduler.h"
+#include "../BasicElements/Container.h"
+#include "../BasicElements/Label.h"
+#include "../BasicElements/FiButton.h"
+
+#ifdef _WIN32
+// На Windows счётчик вызовов есть только у заглушки, поэтому печатаем лишь время
+#define API_CALLS() size_t(0)
+#define RESET_API_CALLS()
+#else
+#define API_CALLS() ConsoleStub::stats.calls
+#define RESET_API_CALLS() ConsoleStub::resetStats()
+#endif
+
+constexpr int iterations = 200;
+
+std::unique_ptr<Container> makeScreen() {
+    auto root = std::make_unique<Container>(SMALL_RECT{ 5, 5, 45, 25 }, Container::Vertical);
+    root->padding = { 1, 1, 1, 1 };
+    for (int i = 0; i < 5; ++i) root->addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 2 }, L"Label " + std::to_wstring(i)));
+    root->rearrangeControls();
+    return root;
+}
+
+// Калькулятор из demo2: 4x4 кнопки + дисплей
+std::vector<std::shared_ptr<Button>> makeCalculator() {
+    std::vector<std::shared_ptr<Button>> buttons;
+    const wchar_t* layout = L"789/456*123-0.=+";
+    for (SHORT i = 0; i < 16; ++i) {
+        SHORT left = 10 + (i % 4) * 11;
+        SHORT top = 6 + (i / 4) * 3;
+        auto btn = std::make_shared<FIButton>(SMALL_RECT{ left, top, static_cast<SHORT>(left + 10), static_cast<SHORT>(top + 2) }, layout[i]);
+        buttons.push_back(btn);
+        FocusManager::registerControl(btn);
+    }
+    FocusManager::registerControl(std::make_shared<Label>(SMALL_RECT{ 10, 2, 53, 4 }, L"0"));
+    return buttons;
+}
+
+// Мышь переезжает с одной кнопки на соседнюю: раздаём событие всем кнопкам, как EventManager
+void hover(const std::vector<std::shared_ptr<Button>>& buttons, COORD pos) {
+    MOUSE_EVENT_RECORD mer {};
+    mer.dwMousePosition = pos;
+    mer.dwEventFlags = MOUSE_MOVED;
+    Render::Frame frame;
+    for (auto& btn : buttons) btn->onMouse(mer);
+    FrameScheduler::drain();
+}
+
+void run(const char* name, Container& root) {
+    RESET_API_CALLS();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        Render::Frame frame;
+        root.draw();
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name
+              << ": api calls/redraw = " << API_CALLS() / iterations
+              << ", us/redraw = " << elapsed / iterations << std::endl;
+}
+
+int main() {
+    auto root = makeScreen();
+
+    run("direct ", *root);
+
+    Render::enableBackBuffer();
+    run("surface", *root);
+    std::cout << "surface: avg cells/present = " << Render::stats.cellsPresented / (std::max<size_t>)(Render::stats.presents, 1) << std::endl;
+
+    // Смена подсветки в калькуляторе: в консоль должны уйти только две кнопки
+    auto buttons = makeCalculator();
+    FocusManager::redrawAll();
+    hover(buttons, { 15, 7 });
+    RESET_API_CALLS();
+    hover(buttons, { 26, 7 });
+    std::cout << "hover  : cells/frame = " << Render::stats.lastFrameCells
+              << ", api calls/frame = " << API_CALLS() << std::endl;
+    Render::disableBackBuffer();
+
+    // Те же перерисовки без терминала: стоимость самих виджетов
+    HeadlessBackend headless({ 120, 40 });
+    Render::setBackend(&headless);
+    run("headless direct ", *root);
+    std::cout << "headless direct : runs/redraw = " << headless.stats.runs / iterations << std::endl;
+
+    // VT-терминал: байты на полный кадр (fd = -1 - только подсчёт)
+    VtBackend vt(-1, { 120, 40 });
+    Render::setBackend(&vt);
+    Render::enableBackBuffer();
+    vt.resetStats();
+    {
+        Render::Frame frame;
+        root->draw();
+    }
+    std::cout << "vt     : bytes/full frame = " << vt.stats.lastFrameBytes << std::endl;
+    Render::disableBackBuffer();
+    return 0;
+}
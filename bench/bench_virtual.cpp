@@ -0,0 +1,83 @@
+// Прокрутка колесом длинного списка подписей: N элементов, 400 щелчков колеса вниз и вверх, кадр на щелчок.
+//   scroll  - ScrollContainer, по Label на элемент: щелчок дешёвый, но живут все строки (до 10 000: дальше не влезают в SHORT);
+//   virtual - VirtualScrollContainer: живы только видимые строки и overscan, строки перепривязываются.
+// us/tick - щелчок колеса и кадр; live - живые элементы управления; binds - вызовы bind за щелчок.
+// У virtual us/tick и live одни и те же от тысячи до миллиона элементов.
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "Platform.h"
+#include "Render.h"
+#include "HeadlessBackend.h"
+#include "FrameScheduler.h"
+#include "DemoScreens.h"
+#include "../BasicElements/VirtualScrollContainer.h"
+
+struct Result {
+    double usPerTick {0};
+    size_t live {0};
+    double binds {0};
+};
+
+static Result wheel(ScrollContainer& list, size_t& binds) {
+    const int ticks = 400;
+    binds = 0;
+    std::chrono::nanoseconds total {0};
+    for (int i = 0; i < ticks; ++i) {
+        INPUT_RECORD record = DemoScreens::mouseWheel(10, 10, i < ticks / 2 ? -WHEEL_DELTA : WHEEL_DELTA);
+        auto start = std::chrono::steady_clock::now();
+        list.onMouse(record.Event.MouseEvent);
+        FrameScheduler::drain();
+        total += std::chrono::steady_clock::now() - start;
+    }
+    Result r;
+    r.usPerTick = std::chrono::duration<double, std::micro>(total).count() / ticks;
+    r.live = list.controls.size();
+    r.binds = static_cast<double>(binds) / ticks;
+    return r;
+}
+
+static void print(size_t items, const char* name, const Result& r) {
+    std::cout << std::left << std::setw(10) << items << std::setw(9) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << r.usPerTick << std::setw(9) << r.live
+              << std::setprecision(1) << std::setw(8) << r.binds << std::endl;
+}
+
+int main() {
+    HeadlessBackend screen({ 120, 40 });
+    Render::setBackend(&screen);
+    Render::enableBackBuffer();
+    FrameScheduler::mode = FrameScheduler::Drain;
+
+    std::cout << std::left << std::setw(10) << "items" << std::setw(9) << "list" << std::right << std::setw(12) << "us/tick"
+              << std::setw(9) << "live" << std::setw(8) << "binds" << std::endl;
+    for (size_t items : { size_t(1000), size_t(10000), size_t(100000), size_t(1000000) }) {
+        size_t binds = 0;
+        if (items <= 10000) {
+            ScrollContainer list({ 0, 0, 60, 39 }, Container::Vertical);
+            list.spacing = 0;
+            for (size_t i = 0; i < items; ++i) list.addControl(std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 1 }, L"row " + std::to_wstring(i), 0));
+            list.rearrangeControls();
+            list.draw();
+            print(items, "scroll", wheel(list, binds));
+        }
+
+        VirtualScrollContainer list({ 0, 0, 60, 39 }, 1,
+            [] { return std::make_shared<Label>(SMALL_RECT{ 0, 0, 30, 1 }, L"", 0); },
+            [&binds](Control& row, size_t index) {
+                static_cast<Label&>(row).text = L"row " + std::to_wstring(index);
+                ++binds;
+            });
+        list.spacing = 0;
+        list.setItemCount(items);
+        list.draw();
+        FrameScheduler::drain();
+        print(items, "virtual", wheel(list, binds));
+    }
+
+    Render::disableBackBuffer();
+    return 0;
+}
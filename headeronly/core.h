@@ -11,6 +11,7 @@
 #include <atomic>
 #include <shared_mutex>
 #include <mutex>
+#include "../Core/BasicEventManager.h"
 
 // Forward declaration
 class FocusManager;
@@ -106,249 +107,10 @@ void Control::setFocus(bool f) {
     draw();
 }
 
-template<typename T>
-using HandlerPtr = std::shared_ptr<std::function<void(const T&)>>;
-
-class EventManager {
-private:
-    std::thread eventThread;
-    std::atomic<bool> running;
-
-    // Шаблонный класс для хранения обработчиков и их мьютекса
-    template <typename T>
-    class HandlerContainer {
-    private:
-        std::vector<HandlerPtr<T>> handlers;
-        mutable std::mutex mutex;
-
-    public:
-        // Добавление обработчика
-        HandlerPtr<T> addHandler(std::function<void(const T&)> handler) {
-            std::lock_guard lock(mutex); 
-            auto handlerPtr = std::make_shared<std::function<void(const T&)>>(handler);
-            handlers.push_back(handlerPtr);
-            return handlerPtr; 
-        }
-
-        void clearHandlers() {
-            std::lock_guard lock(mutex);
-            handlers.clear();
-        }
-
-        // Удаление обработчика по указателю
-        bool removeHandler(const HandlerPtr<T>& handlerPtr) {
-            std::lock_guard lock(mutex); // Блокируем мьютекс для записи
-            auto it = std::find_if(handlers.begin(), handlers.end(), [&handlerPtr](const auto& ptr) {
-                return ptr == handlerPtr; // Сравниваем указатели
-            });
-            if (it != handlers.end()) {
-                handlers.erase(it); // Удаляем обработчик
-                return true; // Успешно удалено
-            }
-            return false; // Обработчик не найден
-        }
-
-        // Вызов всех обработчиков
-        void invokeHandlers(const T& event) const {
-            std::vector<HandlerPtr<T>> handlersCopy;
-            {
-                std::lock_guard lock(mutex);
-                handlersCopy = handlers; // Копируем все обработчики при захваченном мьютексе
-            }
-
-            for (const auto& handler : handlersCopy) {
-                (*handler)(event); // Вызываем без захваченного мьютекса
-            }
-        }
-
-    };
-
-
-
-    // Контейнеры для каждого типа событий winAPI, другие не нужны.
-    HandlerContainer<KEY_EVENT_RECORD> keyHandlers;
-    HandlerContainer<MOUSE_EVENT_RECORD> mouseHandlers;
-    HandlerContainer<FOCUS_EVENT_RECORD> focusHandlers;
-    HandlerContainer<MENU_EVENT_RECORD> menuHandlers;
-    HandlerContainer<WINDOW_BUFFER_SIZE_RECORD> windowBufferSizeHandlers;
-    HandlerContainer<INPUT_RECORD> inputHandlers; // Пользователь хочет получать все события
-
-    EventManager() : running(false) {}
-    ~EventManager() { if (running) stop();}
-
-    // Основной цикл обработки событий
-        void eventLoop() {
-        HANDLE hInput = GetStdHandle(STD_INPUT_HANDLE);
-        if (hInput == INVALID_HANDLE_VALUE) {
-            return;
-        }
-
-        while (running) {
-            INPUT_RECORD inputRecords[128];
-            DWORD eventsRead;
-
-            if (!ReadConsoleInput(hInput, inputRecords, 128, &eventsRead)) { // Если больше 128 - нам это не нужно.
-                std::cerr << "Error reading console input" << std::endl; // Ошибка - прерываем поток.
-                stop();
-                return;
-            }
-
-            for (DWORD i = 0; i < eventsRead && running; ++i) {
-                switch (inputRecords[i].EventType) {
-                    case KEY_EVENT:
-                        keyHandlers.invokeHandlers(inputRecords[i].Event.KeyEvent);
-                        break;
-                    case MOUSE_EVENT:
-                        mouseHandlers.invokeHandlers(inputRecords[i].Event.MouseEvent);
-                        break;
-                    case FOCUS_EVENT:
-                        focusHandlers.invokeHandlers(inputRecords[i].Event.FocusEvent);
-                        break;
-                    case MENU_EVENT:
-                        menuHandlers.invokeHandlers(inputRecords[i].Event.MenuEvent);
-                        break;
-                    case WINDOW_BUFFER_SIZE_EVENT:
-                        windowBufferSizeHandlers.invokeHandlers(inputRecords[i].Event.WindowBufferSizeEvent);
-                        break;
-                    default:
-                        inputHandlers.invokeHandlers(inputRecords[i]);
-                        break;
-                }
-            }
-        }
-    }
-
-public:
-    // Получение экземпляра менеджера событий (Singleton)
-    static EventManager& getInstance() {
-        static EventManager instance;
-        return instance;
-    }
-
-    void clearAllHandlers() {
-        keyHandlers.clearHandlers();
-        mouseHandlers.clearHandlers();
-        focusHandlers.clearHandlers();
-        menuHandlers.clearHandlers();
-        windowBufferSizeHandlers.clearHandlers();
-        inputHandlers.clearHandlers();
-    }
-
-    // Добавление обработчиков для каждого типа событий
-    template <typename T>
-    inline HandlerPtr<T> addHandler(std::function<void(const T&)> handler) {
-        if constexpr (std::is_same_v<T, KEY_EVENT_RECORD>) {
-            return keyHandlers.addHandler(handler);
-        } else if constexpr (std::is_same_v<T, MOUSE_EVENT_RECORD>) {
-            return mouseHandlers.addHandler(handler);
-        } else if constexpr (std::is_same_v<T, FOCUS_EVENT_RECORD>) {
-            return focusHandlers.addHandler(handler);
-        } else if constexpr (std::is_same_v<T, MENU_EVENT_RECORD>) {
-            return menuHandlers.addHandler(handler);
-        } else if constexpr (std::is_same_v<T, WINDOW_BUFFER_SIZE_RECORD>) {
-            return windowBufferSizeHandlers.addHandler(handler);
-        } else if constexpr (std::is_same_v<T, INPUT_RECORD>) {
-            return inputHandlers.addHandler(handler);
-        }
-    }
-
-    template <typename T>
-    inline bool removeHandler(const HandlerPtr<T>& handlerPtr) {
-        if constexpr (std::is_same_v<T, KEY_EVENT_RECORD>) {
-            return keyHandlers.removeHandler(handlerPtr);
-        } else if constexpr (std::is_same_v<T, MOUSE_EVENT_RECORD>) {
-            return mouseHandlers.removeHandler(handlerPtr);
-        } else if constexpr (std::is_same_v<T, FOCUS_EVENT_RECORD>) {
-            return focusHandlers.removeHandler(handlerPtr);
-        } else if constexpr (std::is_same_v<T, MENU_EVENT_RECORD>) {
-            return menuHandlers.removeHandler(handlerPtr);
-        } else if constexpr (std::is_same_v<T, WINDOW_BUFFER_SIZE_RECORD>) {
-            return windowBufferSizeHandlers.removeHandler(handlerPtr);
-        } else if constexpr (std::is_same_v<T, INPUT_RECORD>) {
-            return inputHandlers.removeHandler(handlerPtr);
-        }
-    }
-
-    template <typename T>
-    inline void clearAllHandlers() {
-        if constexpr (std::is_same_v<T, KEY_EVENT_RECORD>) {
-            keyHandlers.clearHandlers();
-        } else if constexpr (std::is_same_v<T, MOUSE_EVENT_RECORD>) {
-             mouseHandlers.clearHandlers();
-        } else if constexpr (std::is_same_v<T, FOCUS_EVENT_RECORD>) {
-             focusHandlers.clearHandlers();
-        } else if constexpr (std::is_same_v<T, MENU_EVENT_RECORD>) {
-             menuHandlers.clearHandlers();
-        } else if constexpr (std::is_same_v<T, WINDOW_BUFFER_SIZE_RECORD>) {
-             windowBufferSizeHandlers.clearHandlers();
-        } else if constexpr (std::is_same_v<T, INPUT_RECORD>) {
-             inputHandlers.clearHandlers();
-        }
-    }
-
-    // Запуск обработчика событий
-    void start() { // Разрешаем повторный запуск.
-        running = true;
-        eventThread = std::thread([this]() { this->eventLoop(); });
-    }
-
-    // Остановка обработчика событий
-    void stop() { // мягко прерываем поток.
-        running = false;
-        if (eventThread.joinable()) {
-            eventThread.join();
-        }
-    }
-};
-
-class FocusManager {
-private:
-    static inline std::vector<std::shared_ptr<Control>> controls;
-    static inline int focusedIndex = -1;
-
-public:
-    static void registerControl(const std::shared_ptr<Control>& ctrl) {
-        controls.push_back(ctrl);
-    }
-
-    static void clearControls() {
-        controls.clear();
-        focusedIndex = -1;
-    }
-
-    static void focusControl(Control* ctrl) {
-        if (focusedIndex != -1){
-            controls[focusedIndex]->setFocus(false);
-        }
-        auto it = std::find_if(controls.begin(), controls.end(),
-                               [ctrl](const std::shared_ptr<Control>& c) { return c.get() == ctrl; });
-        if (it != controls.end()) {
-            focusedIndex = std::distance(controls.begin(), it);
-            controls[focusedIndex]->setFocus(true);
-        }
-    }
-
-    static void nextFocus() {
-        if (controls.empty()) return;
-        if (focusedIndex != -1){
-            controls[focusedIndex]->setFocus(false);
-        }
-        if ((GetKeyState(VK_SHIFT) & 0x8000) != 0) {
-            focusedIndex = (focusedIndex + controls.size() - 1) % controls.size();
-        } else {
-            focusedIndex = (focusedIndex + 1) % controls.size();
-        }
-        controls[focusedIndex]->setFocus(true);
-    }
-
-    static void redrawAll() {
-        for (auto& ctrl : controls) {
-            ctrl->draw();
-        }
-    }
-
-};
-
+// Тот же конвейер ввода, что у Core/EventManager.h (очередь, слияние, полосы, run/requestExit),
+// но без FrameScheduler и MouseRouter: элементы этого заголовка сами подписываются на мышь
+// и рисуют сразу. Обработчики вызываются под ConsoleHost::mutex(), списки - с политикой Locked.
+using EventManager = BasicEventManager<Locked, ConsoleHost>;
 
 class InputState {
 public:
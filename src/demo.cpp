@@ -15,6 +15,7 @@
 void KeyHandler(const KEY_EVENT_RECORD& ker) {
     if (ker.bKeyDown && ker.wVirtualKeyCode == VK_TAB) FocusManager::nextFocus();
     else if (ker.bKeyDown && ker.wVirtualKeyCode == VK_SPACE) FocusManager::getFocused()->action();
+    else if (ker.bKeyDown && ker.wVirtualKeyCode == VK_ESCAPE) EventManager::getInstance().requestExit();
 }
 
 void CFButton::action() {
@@ -41,13 +42,10 @@ int main() {
 
     auto& eventManager = EventManager::getInstance();
     eventManager.addHandler<KEY_EVENT_RECORD>(KeyHandler);
-    eventManager.start();
 
     InputState::setConsoleCursorPosition({ 0, 0 });
     std::cout << " [Press ESC to exit...] " << std::endl;
-    while (!InputState::isKeyPressed(VK_ESCAPE)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    eventManager.run();
     SetConsoleMode(hin, mode);
     return 0;
 }
@@ -12,9 +12,11 @@
 #include "Control.h"
 #include "../BasicElements/FIButton.h"
 #include "../BasicElements/Label.h"
+#include "../BasicElements/GridContainer.h"
 
 class CalculatorForm {
     std::shared_ptr<Label> display;
+    std::shared_ptr<GridContainer> keys;
     std::vector<std::shared_ptr<Button>> buttons;
 
 public:
@@ -28,28 +30,22 @@ public:
             L"0", L".", L"=", L"+"
         };
 
-        SHORT constexpr startX = 10;
-        SHORT constexpr startY = 6;
-        SHORT constexpr buttonWidth = 10;
-        SHORT constexpr buttonHeight = 2;
-        SHORT constexpr cols = 4;
+        // Четыре равных столбца и строки: кнопки 10x2 через промежуток в одну клетку
+        keys = std::make_shared<GridContainer>(SMALL_RECT{10, 6, 53, 17}, std::vector<GridTrack>(4, GridTrack::star()), std::vector<GridTrack>(4, GridTrack::star()));
+        keys->bordered = false;
 
         for (size_t i = 0; i < layout.size(); ++i) {
-            SHORT row = i / cols;
-            SHORT col = i % cols;
-            SHORT left = startX + col * (buttonWidth + 1);
-            SHORT top = startY + row * (buttonHeight + 1);
-            SMALL_RECT r = { left, top, left + buttonWidth, top + buttonHeight };
-
-            auto btn = std::make_shared<FIButton>(r, layout[i]);
+            auto btn = std::make_shared<FIButton>(SMALL_RECT{0, 0, 10, 2}, layout[i]);
 
             btn->onClick = [this, text = layout[i]]() {
                 this->onButtonClick(text);
             };
 
+            keys->addControl(btn);
             buttons.push_back(btn);
             FocusManager::registerControl(btn);
         }
+        keys->rearrangeControls();
         FocusManager::registerControl(display);
     }
 
@@ -199,6 +195,8 @@ private:
 void KeyHandler(const KEY_EVENT_RECORD& ker) {
     if (ker.bKeyDown && ker.wVirtualKeyCode == VK_TAB) {
         FocusManager::nextFocus();
+    } else if (ker.bKeyDown && ker.wVirtualKeyCode == VK_ESCAPE) {
+        EventManager::getInstance().requestExit();
     }
 }
 
@@ -257,14 +255,11 @@ int main() {
     auto& eventManager = EventManager::getInstance();
     eventManager.addHandler<KEY_EVENT_RECORD>(KeyHandler);
     eventManager.addHandler<KEY_EVENT_RECORD>([&calc](const KEY_EVENT_RECORD& ker) { CalcHandler(ker, calc); });
-    eventManager.start();
 
     InputState::setConsoleCursorPosition({ 0, 0 });
     std::cout << " [Press ESC to exit...] " << std::endl;
 
-    while (!InputState::isKeyPressed(VK_ESCAPE)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    eventManager.run();
 
     return 0;
 }
@@ -19,36 +19,32 @@
 #include "Control.h"
 #include "Render.h"
 #include "Label.h"
+#include "VirtualScrollContainer.h"
+#include "MouseRouter.h"
 
 namespace fs = std::filesystem;
 std::wstring currentPath = fs::absolute(L".").wstring();
 void loadDirectory(const std::wstring& path);
 HANDLE hin, hout;
-class FileButton;
-std::vector<std::shared_ptr<FileButton>> allButtons;
-int currentPage = 0;
-int maxButtonsPerPage = 0;
+struct DirEntry {
+    std::wstring name;
+    uint8_t type;   // 0 - файл, 1 - папка, 2 - на уровень выше
+};
+std::vector<DirEntry> entries;
+std::shared_ptr<VirtualScrollContainer> fileList;  // Кнопки только для видимых записей
 constexpr SHORT buttonHeight = 3;
 std::shared_ptr<Label> currentPathLabel = std::make_shared<Label>(SMALL_RECT{60, 2, 110, 5}, L"0");
 std::shared_ptr<Label> helpLabel = std::make_shared<Label>(SMALL_RECT{60, 7, 110, 10}, L"[Press ESC to exit...]", 3);
 std::shared_ptr<Label> pageLabel = std::make_shared<Label>(SMALL_RECT{60, 10, 110, 13}, L"0", 3);
-std::shared_ptr<Label> pageHelpLabel = std::make_shared<Label>(SMALL_RECT{60, 13, 110, 15}, L"[Use F9/F10 to change page]", 2);
+std::shared_ptr<Label> pageHelpLabel = std::make_shared<Label>(SMALL_RECT{60, 13, 110, 15}, L"[Use wheel or F9/F10 to scroll]", 2);
 
 class FileButton : public Control, public Render, public std::enable_shared_from_this<FileButton>  {
-HandlerPtr<MOUSE_EVENT_RECORD> handler;
 public:
     std::wstring name;
     uint8_t type = 0;
 
     void initHandlers() {
-        auto self = shared_from_this();
-        if (handler) EventManager::getInstance().removeHandler<MOUSE_EVENT_RECORD>(handler);
-        handler = EventManager::getInstance().addHandler<MOUSE_EVENT_RECORD>([self](const MOUSE_EVENT_RECORD& mer) {
-            self->onMouse(mer);
-        });
-    }
-    ~FileButton() {
-        EventManager::getInstance().removeHandler<MOUSE_EVENT_RECORD>(handler);
+        MouseRouter::add(this);  // Уже зарегистрирована - обновится rect
     }
 
     FileButton(SMALL_RECT r, const std::wstring& n, uint8_t t = 0)
@@ -65,6 +61,7 @@ public:
     }
 
     void onMouse(const MOUSE_EVENT_RECORD& mer) override {
+        auto self = shared_from_this();  // action() может пересоздать кнопки, в том числе эту
         Control::onMouse(mer);
         if (hovered && (mer.dwButtonState & FROM_LEFT_1ST_BUTTON_PRESSED)) {
             FocusManager::focusControl(this);
@@ -89,27 +86,34 @@ public:
     }
 };
 
-void redrawCurrentPage() {
+void redrawFileList(bool keepScroll) {
     // Считаем размер консоли
     GetConsoleScreenBufferInfo(hout, &Render::csbi);
-    maxButtonsPerPage = (Render::csbi.dwSize.Y - 5) / buttonHeight;
+    int scrollY = keepScroll && fileList ? fileList->scrollY : 0;
 
     Render::clearScreen();
-    FocusManager::clearControls();  
-    EventManager::getInstance().clearAllHandlers<MOUSE_EVENT_RECORD>(); 
-
-    int start = currentPage * maxButtonsPerPage;
-    int end = (((start + maxButtonsPerPage) < ((int)allButtons.size())) ? (start + maxButtonsPerPage) : ((int)allButtons.size()));
-
-    SHORT top = 2;
-    for (int i = start; i < end; ++i) {
-        allButtons[i]->rect = SMALL_RECT{5, top, 50, static_cast<short>(top + 2)};
-        allButtons[i]->initHandlers();  
-        FocusManager::registerControl(allButtons[i]);  
-        top += buttonHeight;
-    }
+    FocusManager::clearControls();
+    fileList.reset();      // Старые кнопки снимаются с MouseRouter сами
+    MouseRouter::clear();  // Мышь получают только кнопки списка
+
+    fileList = std::make_shared<VirtualScrollContainer>(SMALL_RECT{5, 2, 50, static_cast<SHORT>(Render::csbi.dwSize.Y - 3)}, buttonHeight - 1,
+        [] {
+            auto button = std::make_shared<FileButton>(SMALL_RECT{5, 0, 50, buttonHeight - 1}, L"");
+            button->initHandlers();
+            return button;
+        },
+        [](Control& row, size_t index) {
+            auto& button = static_cast<FileButton&>(row);
+            button.name = entries[index].name;
+            button.type = entries[index].type;
+        });
+    fileList->bordered = false;
+    fileList->setItemCount(entries.size());
+    fileList->scrollBy(scrollY);
+    for (auto& row : fileList->controls) FocusManager::registerControl(row);
+
     currentPathLabel->text = currentPath;
-    pageLabel->text = std::to_wstring(currentPage) + L" / " + std::to_wstring(allButtons.size() / maxButtonsPerPage);
+    pageLabel->text = std::to_wstring(entries.size()) + L" items";
 
     if (currentPathLabel->rect.Right < Render::csbi.dwSize.X - 5) {
         FocusManager::registerControl(currentPathLabel);
@@ -124,13 +128,12 @@ void redrawCurrentPage() {
 void loadDirectory(const std::wstring& path) {
     if (!fs::is_directory(path)) return;
 
-    // Создаем кнопки
-    allButtons.clear();  // Очистка всех старых кнопок
-    if (fs::path(path) != fs::path(path).root_path()) allButtons.push_back(std::make_shared<FileButton>(SMALL_RECT{5, 0, 50, 0}, fs::path(path).parent_path().filename().wstring(), 2));
-    for (const auto& entry : fs::directory_iterator(path)) allButtons.push_back(std::make_shared<FileButton>(SMALL_RECT{5, 0, 50, 0}, entry.path().filename().wstring(), entry.is_directory()));
-    
-    currentPage = 0;     // Сброс текущей страницы
-    redrawCurrentPage();  // Обновить экран после загрузки новых кнопок
+    // Только имена: кнопки создаёт список, для видимых записей
+    entries.clear();
+    if (fs::path(path) != fs::path(path).root_path()) entries.push_back({ fs::path(path).parent_path().filename().wstring(), 2 });
+    for (const auto& entry : fs::directory_iterator(path)) entries.push_back({ entry.path().filename().wstring(), static_cast<uint8_t>(entry.is_directory()) });
+
+    redrawFileList(false);  // Обновить экран с начала списка
 }
 
 void KeyHandler(const KEY_EVENT_RECORD& ker) {
@@ -140,20 +143,15 @@ void KeyHandler(const KEY_EVENT_RECORD& ker) {
         } else if (ker.wVirtualKeyCode == VK_SPACE) {
             FocusManager::getFocused()->action();
         } else if (ker.wVirtualKeyCode == VK_F9) { // PageUp
-            if (currentPage > 0) {
-                currentPage--;
-                redrawCurrentPage();
-            }
+            fileList->scrollBy(-(fileList->rect.Bottom - fileList->rect.Top));
         } else if (ker.wVirtualKeyCode == VK_F10) { // PageDown
-            int maxPage = (allButtons.size() + maxButtonsPerPage - 1) / maxButtonsPerPage - 1;
-            if (currentPage < maxPage) {
-                currentPage++;
-                redrawCurrentPage();
-            }
+            fileList->scrollBy(fileList->rect.Bottom - fileList->rect.Top);
         } else if (ker.wVirtualKeyCode == VK_UP) {
             FocusManager::prevFocus();
         } else if (ker.wVirtualKeyCode == VK_DOWN) {
             FocusManager::nextFocus();
+        } else if (ker.wVirtualKeyCode == VK_ESCAPE) {
+            EventManager::getInstance().requestExit();
         }
     }
 }
@@ -163,7 +161,7 @@ void WindowHandler(const WINDOW_BUFFER_SIZE_RECORD& wbsr) {
     GetConsoleScreenBufferInfo(hout, &Render::csbi);
     if (csbi.dwSize.X == Render::csbi.dwSize.X || csbi.dwSize.Y == Render::csbi.dwSize.Y) return;
     Render::csbi = csbi;
-    redrawCurrentPage();
+    redrawFileList(true);
 }
 
 int main() {
@@ -180,10 +178,6 @@ int main() {
 
     loadDirectory(currentPath);
 
-    eventManager.start();
-
-    while (!InputState::isKeyPressed(VK_ESCAPE)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    eventManager.run();
     return 0;
 }
\ No newline at end of file
@@ -18,12 +18,12 @@ public:
     void draw() override {
         if (bordered) Render::DrawBox(rect);
 
-        FillConsoleOutputAttribute(Render::hout, { FOREGROUND_GREEN | FOREGROUND_RED }, 1, { rect.Left, rect.Top }, &Render::dump);
-        WriteConsoleOutputCharacterW(Render::hout, L"[", 1, { rect.Left, rect.Top }, &Render::dump);
-        FillConsoleOutputAttribute(Render::hout, { FOREGROUND_RED }, 1, { short (rect.Left + 1), rect.Top }, &Render::dump);
-        WriteConsoleOutputCharacterW(Render::hout, &character, 1, { short (rect.Left + 1), rect.Top }, &Render::dump);
-        FillConsoleOutputAttribute(Render::hout, { FOREGROUND_GREEN | FOREGROUND_RED }, 1, { short (rect.Left + 2), rect.Top }, &Render::dump);
-        WriteConsoleOutputCharacterW(Render::hout, L"]", 1, { short (rect.Left + 2), rect.Top }, &Render::dump);
+        const Cell cells[] = {
+            { L'[', FOREGROUND_GREEN | FOREGROUND_RED },
+            { character, FOREGROUND_RED },
+            { L']', FOREGROUND_GREEN | FOREGROUND_RED },
+        };
+        Render::drawCells({ rect.Left, rect.Top }, cells, 3);
     }
 };
 
@@ -67,9 +67,11 @@ int main() {
     InputState::setConsoleCursorPosition({ 0, 0 });
     std::wcout << L" [Press ESC to exit...] " << std::endl;
 
-    while (!InputState::isKeyPressed(VK_ESCAPE)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    auto& eventManager = EventManager::getInstance();
+    eventManager.addHandler<KEY_EVENT_RECORD>([&eventManager](const KEY_EVENT_RECORD& ker) {
+        if (ker.bKeyDown && ker.wVirtualKeyCode == VK_ESCAPE) eventManager.requestExit();
+    });
+    eventManager.run();
 
     SetConsoleMode(hin, mode);
     std::cout << "Program finished correctly" << std::endl;
@@ -41,12 +41,12 @@ public:
     void draw() override {
         CFButton::draw();
         if (bordered) Render::DrawBox(rect);
-        FillConsoleOutputAttribute(Render::hout, { FOREGROUND_GREEN | FOREGROUND_RED }, 1, { rect.Left, rect.Top }, &Render::dump);
-        WriteConsoleOutputCharacterW(Render::hout, L"[", 1, { rect.Left, rect.Top }, &Render::dump);
-        FillConsoleOutputAttribute(Render::hout, { FOREGROUND_RED }, 1, { short (rect.Left + 1), rect.Top }, &Render::dump);
-        WriteConsoleOutputCharacterW(Render::hout, &character, 1, { short (rect.Left + 1), rect.Top }, &Render::dump);
-        FillConsoleOutputAttribute(Render::hout, { FOREGROUND_GREEN | FOREGROUND_RED }, 1, { short (rect.Left + 2), rect.Top }, &Render::dump);
-        WriteConsoleOutputCharacterW(Render::hout, L"]", 1, { short (rect.Left + 2), rect.Top }, &Render::dump);
+        const Cell cells[] = {
+            { L'[', FOREGROUND_GREEN | FOREGROUND_RED },
+            { character, FOREGROUND_RED },
+            { L']', FOREGROUND_GREEN | FOREGROUND_RED },
+        };
+        Render::drawCells({ rect.Left, rect.Top }, cells, 3);
     }
 
     void action() override;
@@ -71,10 +71,11 @@ int main() {
     ROOT_SETUP(root)
     DISPLAY_SETUP
 
-    EventManager::getInstance().start();
-    while (!InputState::isKeyPressed(VK_ESCAPE)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    auto& eventManager = EventManager::getInstance();
+    eventManager.addHandler<KEY_EVENT_RECORD>([&eventManager](const KEY_EVENT_RECORD& ker) {
+        if (ker.bKeyDown && ker.wVirtualKeyCode == VK_ESCAPE) eventManager.requestExit();
+    });
+    eventManager.run();
 
     SetConsoleMode(hin, mode);
     return 0;